@@ -0,0 +1,65 @@
+/*
+ * WFI until a hardware alarm fires, see alarm_sleep.h
+ */
+#include "alarm_sleep.h"
+#include <hardware/sync.h>
+#include <hardware/timer.h>
+#if PICO_ON_DEVICE
+#include <hardware/structs/clocks.h>
+#include <hardware/structs/scb.h>
+#endif
+
+static volatile bool alarm_fired[NUM_TIMERS]; // set from the timer IRQ, one flag per hardware alarm
+
+static void on_alarm(uint alarm_num){
+    alarm_fired[alarm_num] = true;
+}
+
+Alarm_Sleep::Alarm_Sleep(){
+    alarm = hardware_alarm_claim_unused(true);
+    hardware_alarm_set_callback(alarm, on_alarm);
+}
+
+Alarm_Sleep::~Alarm_Sleep(){
+    hardware_alarm_set_callback(alarm, NULL);
+    hardware_alarm_unclaim(alarm);
+}
+
+/*
+ * With gate_clocks, every clock except the timer's is gated while the core sleeps on the board.
+ *  The gating only takes effect once both cores are asleep, so core 1 should be idle (or in WFI) too.
+ */
+void Alarm_Sleep::sleep_until_us(uint64_t target_us, bool gate_clocks){
+    alarm_fired[alarm] = false;
+    if(hardware_alarm_set_target(alarm, target_us))
+        return; // already late
+
+#if PICO_ON_DEVICE
+    uint32_t en0 = clocks_hw->sleep_en0;
+    uint32_t en1 = clocks_hw->sleep_en1;
+    if(gate_clocks){
+        clocks_hw->sleep_en0 = 0;
+        clocks_hw->sleep_en1 = CLOCKS_SLEEP_EN1_CLK_SYS_TIMER_BITS | CLOCKS_SLEEP_EN1_CLK_SYS_WATCHDOG_BITS;
+        scb_hw->scr |= M0PLUS_SCR_SLEEPDEEP_BITS;
+    }
+#else
+    (void)gate_clocks;
+#endif
+
+    // WFI wakes on a pending interrupt even while they are masked
+    uint32_t status = save_and_disable_interrupts();
+    while(!alarm_fired[alarm]){
+        __wfi();
+        restore_interrupts(status);
+        status = save_and_disable_interrupts();
+    }
+    restore_interrupts(status);
+
+#if PICO_ON_DEVICE
+    if(gate_clocks){
+        scb_hw->scr &= ~M0PLUS_SCR_SLEEPDEEP_BITS;
+        clocks_hw->sleep_en0 = en0;
+        clocks_hw->sleep_en1 = en1;
+    }
+#endif
+}
@@ -0,0 +1,25 @@
+/*
+ * Sleep the core in WFI until a hardware alarm fires. Shared by HDC1080_Low_Power and the
+ *  Async_Executor so the wakeup handshake is written once.
+ *
+ *  The flag set by the alarm IRQ is checked and WFI entered with interrupts masked. An alarm that
+ *  fires between the check and the WFI stays pending and ends the WFI instead of being lost, the
+ *  handler then runs as soon as interrupts are restored.
+ */
+#ifndef ALARM_SLEEP_H
+#define ALARM_SLEEP_H
+
+#include <stdint.h>
+
+class Alarm_Sleep {
+    private:
+        int alarm;      // claimed hardware alarm
+
+    public:
+        Alarm_Sleep();  // claims an unused hardware alarm, panics if there is none
+        ~Alarm_Sleep();
+
+        void sleep_until_us(uint64_t target_us, bool gate_clocks=false); // returns right away if target_us already passed
+};
+
+#endif
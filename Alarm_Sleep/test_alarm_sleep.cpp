@@ -0,0 +1,34 @@
+/*
+ * Tests for sleeping on a hardware alarm
+ */
+#include "sim_test.h"
+#include "sim.h"
+#include "alarm_sleep.h"
+#include <hardware/timer.h>
+
+static void test_sleeps_until_target(){
+    sim_reset();
+    Alarm_Sleep sleeper;
+    sleeper.sleep_until_us(5000);
+    CHECK_EQ(time_us_64(), 5000);
+    CHECK(sim_stats().sleep_cycles >= (uint64_t)4900 * SIM_CYCLES_PER_US);
+
+    sleeper.sleep_until_us(20000, true);
+    CHECK_EQ(time_us_64(), 20000);
+}
+
+static void test_late_target(){
+    sim_reset();
+    Alarm_Sleep sleeper;
+    sim_charge((uint64_t)1000 * SIM_CYCLES_PER_US);
+    uint64_t sleep_before = sim_stats().sleep_cycles;
+    sleeper.sleep_until_us(500);        // already passed, returns without sleeping
+    CHECK_EQ(time_us_64(), 1000);
+    CHECK_EQ(sim_stats().sleep_cycles, sleep_before);
+}
+
+int main(){
+    RUN_TEST(test_sleeps_until_target);
+    RUN_TEST(test_late_target);
+    return TEST_RESULT();
+}
@@ -0,0 +1,250 @@
+/*
+ * Allocation-free C++20 coroutine executor for one core. Driver operations that wait (sensor
+ *  conversions, stepper moves, delays) suspend the coroutine instead of blocking the core, so
+ *  hundreds of tasks can interleave without an RTOS or hand written state machines:
+ *
+ *      Async<void> log_task(Async_HDC1080* hdc){
+ *          while(true){
+ *              uint16_t t, h;
+ *              if(co_await hdc->read_both_raw(HIGH_RES, &t, &h))
+ *                  ...
+ *              co_await sleep_for(1000);
+ *          }
+ *      }
+ *
+ *  Coroutine frames come from a fixed block pool handed to the Executor, never from the heap.
+ *  Waiting tasks sit in a timer queue sorted by wake time; the queue nodes live inside the waiting
+ *  coroutine frames. While nothing is due the core sleeps in WFI on a hardware alarm.
+ *
+ *  Needs C++20 (-std=c++20, GCC 10 also -fcoroutines), the CMake target sets both.
+ */
+#ifndef ASYNC_H
+#define ASYNC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <coroutine>
+#include "alarm_sleep.h"
+
+#ifndef ASYNC_FRAME_BYTES
+#define ASYNC_FRAME_BYTES 192 /*pool block size, frames larger than this fail to allocate, see Async_Stats::largest_frame*/
+#endif
+
+void* async_frame_alloc(size_t size);   // from the current core's executor pool, NULL if full or too big
+void async_frame_free(void* frame);
+void async_task_finished(void);         // a spawned task ran to completion
+
+/*
+ * A suspended coroutine waiting in one of the executor's queues. Lives in the waiting frame.
+ */
+struct Async_Node {
+    uint64_t wake_us;               // timer queue only
+    std::coroutine_handle<> handle;
+    Async_Node* next;
+};
+
+/*
+ * Promise parts shared by every Async<T>
+ */
+struct Async_Promise_Base {
+    std::coroutine_handle<> continuation;   // coroutine awaiting this one, resumed when it finishes
+    bool detached = false;                  // spawned, nobody awaits it, frees itself when done
+    Async_Node ready_node;                  // the first run of a spawned task is queued with it
+
+    static void* operator new(size_t size) noexcept { return async_frame_alloc(size); }
+    static void operator delete(void* frame, size_t) noexcept { async_frame_free(frame); }
+
+    struct Final_Awaiter {
+        bool await_ready() noexcept { return false; }
+        template<typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+            Async_Promise_Base& p = h.promise();
+            if(p.continuation)
+                return p.continuation;  // straight back into the caller, no trip through the executor
+            if(p.detached){
+                h.destroy();
+                async_task_finished();
+            }
+            return std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }  // lazy: runs once awaited or spawned
+    Final_Awaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { abort(); }                         // drivers don't throw
+};
+
+template<typename T> class Async;
+
+template<typename T>
+struct Async_Promise : Async_Promise_Base {
+    T value{};
+    Async<T> get_return_object() noexcept;
+    static Async<T> get_return_object_on_allocation_failure() noexcept;
+    void return_value(T v) { value = v; }
+    T result(void) { return value; }
+};
+
+template<>
+struct Async_Promise<void> : Async_Promise_Base {
+    Async<void> get_return_object() noexcept;
+    static Async<void> get_return_object_on_allocation_failure() noexcept;
+    void return_void() {}
+    void result(void) {}
+};
+
+/*
+ * Coroutine returning T. co_await it from another coroutine, or Executor::spawn() an Async<void>.
+ *  If the pool had no room for its frame the object is empty: awaiting it returns T() at once and
+ *  spawn() returns false, check Executor::stats().alloc_failures when sizing the pool.
+ */
+template<typename T>
+class Async {
+    public:
+        typedef Async_Promise<T> promise_type;
+        typedef std::coroutine_handle<promise_type> handle_type;
+
+    private:
+        handle_type handle;
+
+    public:
+        Async() : handle(nullptr) {}
+        explicit Async(handle_type h) : handle(h) {}
+        Async(Async&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+        Async(const Async&) = delete;
+        Async& operator=(const Async&) = delete;
+        ~Async(){
+            if(handle)
+                handle.destroy();
+        }
+
+        bool valid(void) const { return (bool)handle; }
+        handle_type release(void){ // hand the frame over, ex. to the executor
+            handle_type h = handle;
+            handle = nullptr;
+            return h;
+        }
+
+        bool await_ready() const noexcept { return !handle; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+            handle.promise().continuation = caller;
+            return handle; // start it now, it resumes the caller when it finishes
+        }
+        T await_resume(){
+            if(!handle)
+                return T();
+            return handle.promise().result();
+        }
+};
+
+template<typename T>
+Async<T> Async_Promise<T>::get_return_object() noexcept {
+    return Async<T>(std::coroutine_handle<Async_Promise<T>>::from_promise(*this));
+}
+
+template<typename T>
+Async<T> Async_Promise<T>::get_return_object_on_allocation_failure() noexcept {
+    return Async<T>();
+}
+
+inline Async<void> Async_Promise<void>::get_return_object() noexcept {
+    return Async<void>(std::coroutine_handle<Async_Promise<void>>::from_promise(*this));
+}
+
+inline Async<void> Async_Promise<void>::get_return_object_on_allocation_failure() noexcept {
+    return Async<void>();
+}
+
+/*
+ * Counters for sizing the frame pool and checking progress
+ */
+struct Async_Stats {
+    uint32_t tasks_live;        // spawned and not finished
+    uint32_t frames_used;
+    uint32_t frames_peak;       // most frames in use at once
+    uint32_t frames_total;      // pool capacity
+    uint32_t alloc_failures;    // frames that didn't fit (pool full or frame > ASYNC_FRAME_BYTES)
+    uint32_t largest_frame;     // biggest frame requested, bytes
+    uint32_t resumes;           // coroutine resumptions by the executor
+};
+
+/*
+ * Runs the coroutines of one core. One executor per core, create it before the coroutines.
+ */
+class Executor {
+    private:
+        void* free_list;            // unused pool blocks, linked through their first word
+        size_t frame_bytes;
+        Async_Stats counters;
+        Async_Node* ready_head;     // FIFO of coroutines to resume
+        Async_Node* ready_tail;
+        Async_Node* timers;         // sorted by wake_us, ties in arrival order
+        Alarm_Sleep sleeper;        // hardware alarm that wakes the core from WFI
+
+    public:
+        Executor(void* frame_memory, size_t bytes, size_t frame_bytes=ASYNC_FRAME_BYTES);
+        ~Executor();
+
+        bool spawn(Async<void>&& task); // start a task, false if its frame couldn't be allocated
+        void run(uint64_t until_us=UINT64_MAX); // until every task finished or the clock reaches until_us
+
+        void schedule(Async_Node* node);    // resume node->handle soon, for awaitables
+        void add_timer(Async_Node* node);   // resume node->handle at node->wake_us, for awaitables
+        void* alloc_frame(size_t size);
+        void free_frame(void* frame);
+        void task_finished(void);
+
+        Async_Stats stats(void) const;
+        static Executor* current(void);     // executor of the calling core, NULL if none
+};
+
+/*
+ * co_await sleep_for(ms): resume the coroutine after at least ms. sleep_for(0) yields to the other
+ *  ready tasks.
+ */
+class Async_Sleep {
+    private:
+        Async_Node node;
+
+    public:
+        explicit Async_Sleep(uint64_t wake_us);
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) noexcept;
+        void await_resume() const noexcept {}
+};
+
+Async_Sleep sleep_for(uint32_t ms);
+Async_Sleep sleep_for_us(uint64_t us);
+Async_Sleep sleep_until_us(uint64_t t_us);  // absolute, time_us_64() units
+
+/*
+ * Lock for sequences that must not interleave, ex. trigger then read on one sensor.
+ *  co_await m.lock(); ... m.unlock(); Waiters get the lock in arrival order.
+ */
+class Async_Mutex {
+    private:
+        bool locked;
+        Async_Node* waiters_head;
+        Async_Node* waiters_tail;
+
+    public:
+        class Lock_Awaiter {
+            private:
+                Async_Mutex* mutex;
+                Async_Node node;
+            public:
+                explicit Lock_Awaiter(Async_Mutex* m) : mutex(m) {}
+                bool await_ready() noexcept;
+                void await_suspend(std::coroutine_handle<> h) noexcept;
+                void await_resume() const noexcept {}
+        };
+
+        Async_Mutex();
+        Lock_Awaiter lock(void);
+        void unlock(void);          // hand the lock to the next waiter
+        bool is_locked(void) const;
+};
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * Awaitable driver operations, see async_drivers.h
+ */
+#include "async_drivers.h"
+#include "hdc1080_low_power.h"
+
+Async_HDC1080::Async_HDC1080(HDC1080* sensor){
+    this->sensor = sensor;
+}
+
+/*
+ * trigger -> suspend for the conversion time -> read, same timing as HDC1080_Low_Power
+ */
+Async<bool> Async_HDC1080::read_both_raw(HDC_Resolution res, uint16_t* temp_raw, uint16_t* hum_raw){
+    co_await busy.lock();
+    sensor->trigger_both(res);
+    co_await sleep_for_us(HDC1080_Low_Power::conversion_time_us(res));
+    int result = sensor->read_both_raw(temp_raw, hum_raw);
+    busy.unlock();
+    co_return result == 0;
+}
+
+Async<bool> Async_HDC1080::read_both(Degrees degrees, HDC_Resolution res, float* dst, int size){
+    uint16_t temp_raw, hum_raw;
+    if(dst == NULL || !co_await read_both_raw(res, &temp_raw, &hum_raw))
+        co_return false;
+
+    if(size == 3){ // C and F
+        dst[0] = sensor->raw_to_float(temp_raw, TEMPERATURE_C);
+        dst[2] = sensor->raw_to_float(temp_raw, TEMPERATURE_F);
+    }else{
+        dst[0] = sensor->raw_to_float(temp_raw, degrees == CELSIUS ? TEMPERATURE_C : TEMPERATURE_F);
+    }
+    dst[1] = sensor->raw_to_float(hum_raw, HUMIDITY);
+    co_return true;
+}
+
+Async_Stepper::Async_Stepper(SM_28BYJ_48* stepper, uint32_t step_interval_us){
+    this->stepper = stepper;
+    this->step_interval_us = step_interval_us;
+}
+
+/*
+ * Steps are scheduled against absolute times so a late wakeup doesn't slow the whole move
+ */
+Async<int> Async_Stepper::move_by(int steps){
+    co_await busy.lock();
+    Direction dir = steps > 0 ? CCW : CW;
+    int remaining = steps > 0 ? steps : -steps;
+    uint64_t next_us = time_us_64();
+
+    while(remaining-- > 0){
+        stepper->step(dir);
+        next_us += step_interval_us;
+        co_await sleep_until_us(next_us);
+    }
+    busy.unlock();
+    co_return stepper->get_offset();
+}
+
+void Async_Stepper::set_step_interval_us(uint32_t us){
+    step_interval_us = us;
+}
@@ -0,0 +1,45 @@
+/*
+ * Awaitable versions of the driver operations that wait. The bus transfers themselves stay short
+ *  blocking SDK calls (a few hundred us), the milliseconds spent waiting on a conversion or between
+ *  steps are spent suspended, so other coroutines run meanwhile.
+ */
+#ifndef ASYNC_DRIVERS_H
+#define ASYNC_DRIVERS_H
+
+#include "async.h"
+#include "hdc1080.h"
+#include "SM_28BYJ-48.h"
+
+/*
+ * HDC1080 reads as coroutines. Concurrent reads of the same sensor take turns, a trigger is never
+ *  interleaved with another task's read.
+ */
+class Async_HDC1080 {
+    private:
+        HDC1080* sensor;
+        Async_Mutex busy;   // one conversion at a time
+
+    public:
+        Async_HDC1080(HDC1080* sensor);
+
+        Async<bool> read_both_raw(HDC_Resolution res, uint16_t* temp_raw, uint16_t* hum_raw); // false on bus error
+        Async<bool> read_both(Degrees degrees, HDC_Resolution res, float* dst, int size);     // same output as HDC1080::read_both()
+};
+
+/*
+ * Stepper moves as coroutines, one step per step_interval_us
+ */
+class Async_Stepper {
+    private:
+        SM_28BYJ_48* stepper;
+        uint32_t step_interval_us;
+        Async_Mutex busy;   // one move at a time
+
+    public:
+        Async_Stepper(SM_28BYJ_48* stepper, uint32_t step_interval_us=2000);
+
+        Async<int> move_by(int steps);  // positive moves CCW (get_offset() counts up), returns the offset when done
+        void set_step_interval_us(uint32_t us);
+};
+
+#endif
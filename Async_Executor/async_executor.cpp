@@ -0,0 +1,212 @@
+/*
+ * Allocation-free C++20 coroutine executor, see async.h
+ */
+#include "async.h"
+#include <pico/stdlib.h>
+#include <hardware/timer.h>
+
+#define FRAME_ALIGN 16 /*__STDCPP_DEFAULT_NEW_ALIGNMENT__ on the host, more than the M0+ needs*/
+
+static Executor* executors[2];  // one per core
+
+void* async_frame_alloc(size_t size){
+    Executor* ex = Executor::current();
+    return ex == NULL ? NULL : ex->alloc_frame(size);
+}
+
+void async_frame_free(void* frame){
+    Executor::current()->free_frame(frame);
+}
+
+void async_task_finished(void){
+    Executor::current()->task_finished();
+}
+
+/*
+ * Splits frame_memory into blocks of frame_bytes (rounded up to the frame alignment). The
+ *  sleeper claims a hardware alarm for the wakeups.
+ */
+Executor::Executor(void* frame_memory, size_t bytes, size_t frame_bytes){
+    counters = Async_Stats();
+    ready_head = ready_tail = NULL;
+    timers = NULL;
+    free_list = NULL;
+
+    this->frame_bytes = (frame_bytes + FRAME_ALIGN - 1) & ~(size_t)(FRAME_ALIGN - 1);
+    uintptr_t start = ((uintptr_t)frame_memory + FRAME_ALIGN - 1) & ~(uintptr_t)(FRAME_ALIGN - 1);
+    uintptr_t end = (uintptr_t)frame_memory + bytes;
+    for(uintptr_t p = start; p + this->frame_bytes <= end; p += this->frame_bytes){
+        *(void**)p = free_list;
+        free_list = (void*)p;
+        counters.frames_total++;
+    }
+
+    executors[get_core_num()] = this;
+}
+
+Executor::~Executor(){
+    if(executors[get_core_num()] == this)
+        executors[get_core_num()] = NULL;
+}
+
+Executor* Executor::current(void){
+    return executors[get_core_num()];
+}
+
+void* Executor::alloc_frame(size_t size){
+    if(size > counters.largest_frame)
+        counters.largest_frame = (uint32_t)size;
+    if(size > frame_bytes || free_list == NULL){
+        counters.alloc_failures++;
+        return NULL;
+    }
+    void* frame = free_list;
+    free_list = *(void**)frame;
+    if(++counters.frames_used > counters.frames_peak)
+        counters.frames_peak = counters.frames_used;
+    return frame;
+}
+
+void Executor::free_frame(void* frame){
+    *(void**)frame = free_list;
+    free_list = frame;
+    counters.frames_used--;
+}
+
+void Executor::task_finished(void){
+    counters.tasks_live--;
+}
+
+bool Executor::spawn(Async<void>&& task){
+    if(!task.valid())
+        return false;
+    std::coroutine_handle<Async_Promise<void>> h = task.release();
+    Async_Promise<void>& p = h.promise();
+    p.detached = true;
+    p.ready_node.handle = h;
+    counters.tasks_live++;
+    schedule(&p.ready_node);
+    return true;
+}
+
+void Executor::schedule(Async_Node* node){
+    node->next = NULL;
+    if(ready_tail == NULL)
+        ready_head = node;
+    else
+        ready_tail->next = node;
+    ready_tail = node;
+}
+
+/*
+ * Sorted insert, after the nodes with the same wake time so equal sleeps resume in order
+ */
+void Executor::add_timer(Async_Node* node){
+    Async_Node** link = &timers;
+    while(*link != NULL && (*link)->wake_us <= node->wake_us)
+        link = &(*link)->next;
+    node->next = *link;
+    *link = node;
+}
+
+/*
+ * Resume ready coroutines one at a time, moving due timers to the ready queue in between. When
+ *  nothing is ready the core sleeps until the earliest timer. Returns when no task is left, when
+ *  the next wakeup is after until_us (the clock is then at until_us), or when the remaining tasks
+ *  all wait on something other than a timer, ex. a mutex that is never unlocked.
+ */
+void Executor::run(uint64_t until_us){
+    while(counters.tasks_live > 0){
+        uint64_t now = time_us_64();
+        while(timers != NULL && timers->wake_us <= now && timers->wake_us <= until_us){
+            Async_Node* due = timers;
+            timers = due->next;
+            schedule(due);
+        }
+
+        if(ready_head != NULL){
+            Async_Node* node = ready_head;
+            ready_head = node->next;
+            if(ready_head == NULL)
+                ready_tail = NULL;
+            counters.resumes++;
+            node->handle.resume();
+            continue;
+        }
+
+        if(timers == NULL || timers->wake_us > until_us){
+            if(until_us != UINT64_MAX && until_us > now)
+                sleeper.sleep_until_us(until_us);
+            return;
+        }
+        sleeper.sleep_until_us(timers->wake_us);
+    }
+}
+
+Async_Stats Executor::stats(void) const {
+    return counters;
+}
+
+Async_Sleep::Async_Sleep(uint64_t wake_us){
+    node.wake_us = wake_us;
+    node.next = NULL;
+}
+
+void Async_Sleep::await_suspend(std::coroutine_handle<> h) noexcept {
+    node.handle = h;
+    Executor::current()->add_timer(&node);
+}
+
+Async_Sleep sleep_for(uint32_t ms){
+    return Async_Sleep(time_us_64() + (uint64_t)ms * 1000);
+}
+
+Async_Sleep sleep_for_us(uint64_t us){
+    return Async_Sleep(time_us_64() + us);
+}
+
+Async_Sleep sleep_until_us(uint64_t t_us){
+    return Async_Sleep(t_us);
+}
+
+Async_Mutex::Async_Mutex(){
+    locked = false;
+    waiters_head = waiters_tail = NULL;
+}
+
+Async_Mutex::Lock_Awaiter Async_Mutex::lock(void){
+    return Lock_Awaiter(this);
+}
+
+bool Async_Mutex::Lock_Awaiter::await_ready() noexcept {
+    if(mutex->locked)
+        return false;
+    mutex->locked = true;
+    return true;
+}
+
+void Async_Mutex::Lock_Awaiter::await_suspend(std::coroutine_handle<> h) noexcept {
+    node.handle = h;
+    node.next = NULL;
+    if(mutex->waiters_tail == NULL)
+        mutex->waiters_head = &node;
+    else
+        mutex->waiters_tail->next = &node;
+    mutex->waiters_tail = &node;
+}
+
+void Async_Mutex::unlock(void){
+    Async_Node* next = waiters_head;
+    if(next == NULL){
+        locked = false;
+        return;
+    }
+    waiters_head = next->next;
+    if(waiters_head == NULL)
+        waiters_tail = NULL;
+    Executor::current()->schedule(next); // stays locked, now owned by the waiter
+}
+
+bool Async_Mutex::is_locked(void) const {
+    return locked;
+}
@@ -0,0 +1,186 @@
+/*
+ * Tests for the coroutine executor and the awaitable drivers on the simulated board. The virtual
+ *  clock makes every interleaving and wake time exact.
+ */
+#include "sim_test.h"
+#include "sim.h"
+#include "sim_hdc1080.h"
+#include "async.h"
+#include "async_drivers.h"
+#include <pico/stdlib.h>
+#include <vector>
+
+#define POOL_FRAMES 700
+
+alignas(16) static uint8_t frame_pool[POOL_FRAMES * ASYNC_FRAME_BYTES];
+
+struct Wake {
+    int id;
+    uint64_t at_us;
+};
+
+static std::vector<Wake> wakes;
+
+static Async<void> sleeper(int id, uint32_t ms){
+    co_await sleep_for(ms);
+    wakes.push_back({id, time_us_64()});
+}
+
+static void test_sleep_order(){
+    sim_reset();
+    wakes.clear();
+    Executor ex(frame_pool, sizeof(frame_pool));
+    ex.spawn(sleeper(1, 30));
+    ex.spawn(sleeper(2, 10));
+    ex.spawn(sleeper(3, 20));
+    ex.spawn(sleeper(4, 10));   // same wake time as 2, resumes after it
+    ex.run();
+
+    CHECK_EQ(wakes.size(), 4);
+    if(wakes.size() == 4){
+        CHECK_EQ(wakes[0].id, 2);
+        CHECK_EQ(wakes[1].id, 4);
+        CHECK_EQ(wakes[2].id, 3);
+        CHECK_EQ(wakes[3].id, 1);
+        CHECK_EQ(wakes[0].at_us, 10000);
+        CHECK_EQ(wakes[3].at_us, 30000);
+    }
+    CHECK_EQ(ex.stats().tasks_live, 0);
+    CHECK_EQ(ex.stats().frames_used, 0);
+    CHECK(sim_stats().sleep_cycles > sim_stats().active_cycles); // waited in WFI, not spinning
+}
+
+static uint32_t worker_iterations;
+
+static Async<int> child_delay(uint32_t us){
+    co_await sleep_for_us(us);
+    co_return (int)us;
+}
+
+static Async<void> worker(int id){
+    for(int i = 0; i < 10; i++){
+        int waited = co_await child_delay(100 + (id % 7) * 100);
+        if(waited == 100 + (id % 7) * 100)
+            worker_iterations++;
+    }
+}
+
+static void test_hundreds_of_tasks(){
+    sim_reset();
+    worker_iterations = 0;
+    Executor ex(frame_pool, sizeof(frame_pool));
+    for(int i = 0; i < 300; i++)
+        CHECK(ex.spawn(worker(i)));
+    CHECK_EQ(ex.stats().tasks_live, 300);
+    ex.run();
+
+    Async_Stats s = ex.stats();
+    CHECK_EQ(worker_iterations, 3000);
+    CHECK_EQ(s.tasks_live, 0);
+    CHECK_EQ(s.frames_used, 0);
+    CHECK_EQ(s.frames_peak, 600);       // every task and its child at once
+    CHECK_EQ(s.alloc_failures, 0);
+    CHECK(s.largest_frame <= ASYNC_FRAME_BYTES);
+    CHECK_EQ(time_us_64(), 10 * 700);   // the slowest task alone, all of them interleaved
+    printf("largest frame %u bytes, %u resumes\n", s.largest_frame, s.resumes);
+}
+
+static void test_pool_exhaustion(){
+    sim_reset();
+    wakes.clear();
+    alignas(16) static uint8_t small_pool[2 * ASYNC_FRAME_BYTES];
+    Executor ex(small_pool, sizeof(small_pool));
+    CHECK_EQ(ex.stats().frames_total, 2);
+    CHECK(ex.spawn(sleeper(1, 1)));
+    CHECK(ex.spawn(sleeper(2, 1)));
+    CHECK(!ex.spawn(sleeper(3, 1)));        // no frame left, no heap fallback
+    CHECK_EQ(ex.stats().alloc_failures, 1);
+    ex.run();
+    CHECK_EQ(wakes.size(), 2);
+    CHECK_EQ(ex.stats().frames_used, 0);
+}
+
+static Sim_HDC1080 hdc_model;
+static int ticks;
+
+static Async<void> ticker(uint32_t until_ms){
+    while(time_us_64() < until_ms * 1000ull){
+        ticks++;
+        co_await sleep_for(1);
+    }
+}
+
+static Async<void> reader(Async_HDC1080* hdc, float* out, bool* ok){
+    *ok = co_await hdc->read_both(CELSIUS, HIGH_RES, out, 3);
+}
+
+static void test_hdc_reads_interleave(){
+    sim_reset();
+    sim_i2c_attach(i2c0, Sim_HDC1080::ADDRESS, &hdc_model);
+    hdc_model.set_environment(21.5, 40.0);
+    HDC1080 sensor(i2c0);
+    Async_HDC1080 hdc(&sensor);
+    Executor ex(frame_pool, sizeof(frame_pool));
+
+    float a[3] = {}, b[3] = {};
+    bool ok_a = false, ok_b = false;
+    ticks = 0;
+    ex.spawn(reader(&hdc, a, &ok_a));
+    ex.spawn(reader(&hdc, b, &ok_b));   // same sensor, waits for the first read
+    ex.spawn(ticker(30));
+    ex.run();
+
+    CHECK(ok_a && ok_b);
+    CHECK(a[0] > 21.4f && a[0] < 21.6f);
+    CHECK(b[1] > 39.9f && b[1] < 40.1f);
+    CHECK(a[2] > 70.6f && a[2] < 70.8f);
+    CHECK_EQ(hdc_model.get_conversions(), 2);
+    CHECK_EQ(sensor.diagnostics().get_count(DIAG_NACK), 0); // never read before the conversion finished
+    CHECK(ticks >= 29);                 // the ticker kept running during both conversions
+}
+
+static void test_stepper_moves(){
+    sim_reset();
+    SM_28BYJ_48 motor(0, 1, 6, 13);
+    Async_Stepper stepper(&motor, 2000);
+    Executor ex(frame_pool, sizeof(frame_pool));
+
+    struct Mover {
+        static Async<void> run(Async_Stepper* s, int steps, int* result){
+            *result = co_await s->move_by(steps);
+        }
+    };
+    int first = 0, second = 0;
+    uint64_t start = time_us_64();
+    ex.spawn(Mover::run(&stepper, 100, &first));
+    ex.spawn(Mover::run(&stepper, -40, &second));   // queued behind the first move
+    ex.run();
+
+    CHECK_EQ(first, 100);
+    CHECK_EQ(second, 60);
+    CHECK_EQ(motor.get_offset(), 60);
+    CHECK_EQ(time_us_64() - start, 140 * 2000);
+}
+
+static void test_run_until(){
+    sim_reset();
+    Executor ex(frame_pool, sizeof(frame_pool));
+    ticks = 0;
+    ex.spawn(ticker(1000));
+    ex.run(10500);          // 10.5ms of a 1s task
+    CHECK_EQ(time_us_64(), 10500);
+    CHECK_EQ(ticks, 11);
+    CHECK_EQ(ex.stats().tasks_live, 1);
+    ex.run();
+    CHECK_EQ(ticks, 1000);
+}
+
+int main(){
+    RUN_TEST(test_sleep_order);
+    RUN_TEST(test_hundreds_of_tasks);
+    RUN_TEST(test_pool_exhaustion);
+    RUN_TEST(test_hdc_reads_interleave);
+    RUN_TEST(test_stepper_moves);
+    RUN_TEST(test_run_until);
+    return TEST_RESULT();
+}
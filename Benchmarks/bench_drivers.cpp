@@ -0,0 +1,193 @@
+/*
+ * Driver benchmarks on the simulated board: HDC1080 sample cost, raw conversion throughput,
+ *  stepper step cost and 7 segment refresh cost.
+ */
+#include "bench_report.h"
+#include "sim.h"
+#include "sim_hdc1080.h"
+#include "hdc1080.h"
+#include "SM_28BYJ-48.h"
+#include "vandaluino_7segment.h"
+#include "driver_instrument.h"
+
+static Sim_HDC1080 sensor_model;
+
+/*
+ * Fresh board with one HDC1080 on i2c0
+ */
+static void reset_board(void){
+    sim_reset();
+    sim_i2c_attach(i2c0, Sim_HDC1080::ADDRESS, &sensor_model);
+#if DRIVER_INSTRUMENTATION
+    instr_init(); // the reset stopped SysTick, if that is the tick source
+#endif
+}
+
+static const char* res_name(HDC_Resolution res){
+    return res == HIGH_RES ? "14bit" : (res == MEDIUM_RES ? "11bit" : "8bit");
+}
+
+/*
+ * Cost of one sample: time from call to value, and what it put on the bus
+ */
+struct Sample_Cost {
+    double latency_us;
+    double bus_bytes;
+    double transactions;
+};
+
+template<typename Fn>
+static Sample_Cost measure_samples(int samples, Fn fn){
+    reset_board();
+    HDC1080 hdc(i2c0);
+    sim_clear_stats();
+
+    uint64_t start = sim_cycles();
+    for(int i = 0; i < samples; i++)
+        fn(hdc);
+    uint64_t elapsed = sim_cycles() - start;
+
+    Sim_Stats s = sim_stats();
+    Sample_Cost c;
+    c.latency_us = (double)elapsed / SIM_CYCLES_PER_US / samples;
+    c.bus_bytes = (double)s.i2c_bytes / samples;
+    c.transactions = (double)s.i2c_transactions / samples;
+    return c;
+}
+
+static void add_sample_cost(Bench_Report& report, const std::string& prefix, const Sample_Cost& c){
+    report.add(prefix + "/latency", c.latency_us, "us", BENCH_SIM);
+    report.add(prefix + "/bus_bytes", c.bus_bytes, "bytes/sample", BENCH_SIM);
+    report.add(prefix + "/i2c_transactions", c.transactions, "count/sample", BENCH_SIM);
+}
+
+static void bench_hdc1080(Bench_Report& report, int samples){
+    const HDC_Resolution both_res[] = {HIGH_RES, MEDIUM_RES};
+    for(HDC_Resolution res : both_res){
+        float out[3];
+        add_sample_cost(report, std::string("hdc1080/read_both/") + res_name(res),
+            measure_samples(samples, [&](HDC1080& hdc){ hdc.read_both(CELSIUS, res, out, 3); }));
+        add_sample_cost(report, std::string("hdc1080/celsius/") + res_name(res),
+            measure_samples(samples, [&](HDC1080& hdc){ hdc.celsius(res); }));
+
+        // low level API, the caller waits however it likes so only the bus traffic is of interest
+        uint32_t wait_us = res == HIGH_RES ? SIM_HDC_TEMP_14_US + SIM_HDC_HUM_14_US : SIM_HDC_TEMP_11_US + SIM_HDC_HUM_11_US;
+        add_sample_cost(report, std::string("hdc1080/trigger_both_raw/") + res_name(res),
+            measure_samples(samples, [&](HDC1080& hdc){
+                uint16_t t, h;
+                hdc.trigger_both(res);
+                sleep_us(wait_us);
+                hdc.read_both_raw(&t, &h);
+            }));
+    }
+
+    const HDC_Resolution hum_res[] = {HIGH_RES, MEDIUM_RES, LOW_RES};
+    for(HDC_Resolution res : hum_res){
+        add_sample_cost(report, std::string("hdc1080/humidity/") + res_name(res),
+            measure_samples(samples, [&](HDC1080& hdc){ hdc.humidity(res); }));
+    }
+}
+
+/*
+ * raw_to_float() is pure computation, so it is timed on the host CPU
+ */
+static void bench_conversion(Bench_Report& report, int iterations){
+    HDC1080 hdc(i2c0);
+    const HDC_Measure measures[] = {TEMPERATURE_C, TEMPERATURE_F, HUMIDITY};
+    const char* names[] = {"celsius", "fahrenheit", "humidity"};
+
+    for(int m = 0; m < 3; m++){
+        volatile float sink = 0;
+        uint64_t ns = bench_host_best_ns(5, [&](){
+            float acc = 0;
+            for(int i = 0; i < iterations; i++)
+                acc += hdc.raw_to_float((uint16_t)(i * 2654435761u >> 16), measures[m]);
+            sink = acc;
+        });
+        (void)sink;
+        report.add(std::string("hdc1080/raw_to_float/") + names[m] + "/time", (double)ns / iterations, "ns/conversion", BENCH_HOST);
+        report.add(std::string("hdc1080/raw_to_float/") + names[m] + "/throughput", iterations * 1e3 / (double)ns, "Mconversions/s", BENCH_HOST);
+    }
+}
+
+/*
+ * The simulator only charges the GPIO writes, the driver's own code is free there. So the "sim"
+ *  cycles are the modeled bus cost of a step, and the time spent in step() itself is measured on
+ *  the host CPU.
+ */
+static void bench_stepper(Bench_Report& report, int steps){
+    reset_board();
+    SM_28BYJ_48 stepper(0, 1, 6, 13);
+    const int speeds[] = {1, 2};
+
+    for(int speed : speeds){
+        if(speed == 1)
+            stepper.turtle_speed(CW);
+        else
+            stepper.warp_speed_mr_sulu(CW);
+        sim_clear_stats();
+
+        uint64_t start = sim_cycles();
+        for(int i = 0; i < steps; i++)
+            stepper.step();
+        uint64_t elapsed = sim_cycles() - start;
+
+        std::string prefix = std::string("stepper/step/") + (speed == 1 ? "half" : "full");
+        report.add(prefix + "/cycles", (double)elapsed / steps, "modeled cycles/step", BENCH_SIM);
+        report.add(prefix + "/gpio_writes", (double)sim_stats().gpio_writes / steps, "writes/step", BENCH_SIM);
+
+        uint64_t ns = bench_host_best_ns(5, [&](){
+            for(int i = 0; i < steps; i++)
+                stepper.step();
+        });
+        report.add(prefix + "/time", (double)ns / steps, "ns/step", BENCH_HOST);
+    }
+}
+
+static void bench_display(Bench_Report& report, int refreshes){
+    reset_board();
+    init_7_segment();
+    sim_clear_stats();
+
+    uint64_t start = sim_cycles();
+    for(int i = 0; i < refreshes; i++){
+        show_on_left(SEGMENT_NUM[i % 10]);
+        show_on_right(SEGMENT_NUM[(i + 1) % 10]);
+    }
+    uint64_t elapsed = sim_cycles() - start;
+
+    report.add("display/refresh_both_digits/cycles", (double)elapsed / refreshes, "cycles/refresh", BENCH_SIM);
+    report.add("display/refresh_both_digits/gpio_writes", (double)sim_stats().gpio_writes / refreshes, "writes/refresh", BENCH_SIM);
+}
+
+#if DRIVER_INSTRUMENTATION
+/*
+ * Report the same percentiles an application would read on the board
+ */
+static void report_histograms(Bench_Report& report){
+    const char* unit = instr_ticks_per_us() == 1 ? "us" : "cycles";
+    for(int op = 0; op < INSTR_OP_COUNT; op++){
+        Instr_Histogram h = instr_histogram((Instr_Op)op);
+        if(h.count == 0)
+            continue;
+        std::string prefix = std::string("instr/") + instr_op_name((Instr_Op)op);
+        report.add(prefix + "/count", h.count, "samples", BENCH_SIM);
+        report.add(prefix + "/p50", instr_percentile(&h, 50), unit, BENCH_SIM);
+        report.add(prefix + "/p99", instr_percentile(&h, 99), unit, BENCH_SIM);
+        report.add(prefix + "/max", h.max, unit, BENCH_SIM);
+    }
+}
+#endif
+
+void bench_drivers(Bench_Report& report, bool quick){
+#if DRIVER_INSTRUMENTATION
+    instr_reset();
+#endif
+    bench_hdc1080(report, quick ? 4 : 64);
+    bench_conversion(report, quick ? 10000 : 2000000);
+    bench_stepper(report, quick ? 64 : 4096);
+    bench_display(report, quick ? 64 : 4096);
+#if DRIVER_INSTRUMENTATION
+    report_histograms(report);
+#endif
+}
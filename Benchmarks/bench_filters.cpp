@@ -0,0 +1,77 @@
+/*
+ * Cost per sample of the raw code filters, timed on the host CPU. The float baseline is what the
+ *  application used to do: convert every sample with raw_to_float() and average the floats.
+ */
+#include "bench_report.h"
+#include "sensor_filter.h"
+#include "hdc1080.h"
+
+static uint16_t noisy_sample(uint32_t i){
+    uint32_t noise = (i * 2654435761u) >> 27; // 0..31
+    return (uint16_t)(26000 + noise + (i % 97 == 0 ? 9000 : 0)); // occasional spike
+}
+
+template<typename Filter>
+static void bench_filter(Bench_Report& report, const char* name, int samples){
+    volatile uint32_t sink = 0;
+    uint64_t cycles = 0;
+    uint64_t ns = bench_host_best_ns(5, [&](){
+        Filter f;
+        uint32_t acc = 0;
+        uint16_t out;
+        uint64_t c0 = bench_host_cycles();
+        for(int i = 0; i < samples; i++){
+            if(f.push(noisy_sample(i), &out))
+                acc += out;
+        }
+        cycles = bench_host_cycles() - c0;
+        sink = acc;
+    });
+    (void)sink;
+
+    std::string prefix = std::string("filter/") + name;
+    report.add(prefix + "/time", (double)ns / samples, "ns/sample", BENCH_HOST);
+    if(cycles != 0)
+        report.add(prefix + "/cycles", (double)cycles / samples, "host_cycles/sample", BENCH_HOST);
+    report.add(prefix + "/state", sizeof(Filter), "bytes/channel", BENCH_HOST);
+}
+
+/*
+ * The old application side path: convert to float, keep a float window, average it
+ */
+static void bench_float_baseline(Bench_Report& report, int samples){
+    HDC1080 hdc(i2c0);
+    volatile float sink = 0;
+    uint64_t cycles = 0;
+    uint64_t ns = bench_host_best_ns(5, [&](){
+        float window[8] = {0};
+        float acc = 0;
+        uint64_t c0 = bench_host_cycles();
+        for(int i = 0; i < samples; i++){
+            window[i % 8] = hdc.raw_to_float(noisy_sample(i), TEMPERATURE_C);
+            float sum = 0;
+            for(int j = 0; j < 8; j++)
+                sum += window[j];
+            acc += sum / 8;
+        }
+        cycles = bench_host_cycles() - c0;
+        sink = acc;
+    });
+    (void)sink;
+
+    report.add("filter/float_moving_average_8/time", (double)ns / samples, "ns/sample", BENCH_HOST);
+    if(cycles != 0)
+        report.add("filter/float_moving_average_8/cycles", (double)cycles / samples, "host_cycles/sample", BENCH_HOST);
+    report.add("filter/float_moving_average_8/state", 8 * sizeof(float), "bytes/channel", BENCH_HOST);
+}
+
+void bench_filters(Bench_Report& report, bool quick){
+    int samples = quick ? 10000 : 1000000;
+    bench_filter<Moving_Average<8>>(report, "moving_average_8", samples);
+    bench_filter<Median_Filter<3>>(report, "median_3", samples);
+    bench_filter<Median_Filter<5>>(report, "median_5", samples);
+    bench_filter<IIR_Filter<3>>(report, "iir_shift3", samples);
+    bench_filter<Decimator<8>>(report, "decimate_8", samples);
+    bench_filter<Filter_Chain<Median_Filter<3>, IIR_Filter<2>, Decimator<4>>>(report, "chain_median3_iir2_decimate4", samples);
+    bench_float_baseline(report, samples);
+}
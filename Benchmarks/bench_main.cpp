@@ -0,0 +1,45 @@
+/*
+ * Benchmark runner for the host build.
+ *  usage: drivers_bench [--json results.json] [--quick]
+ *      --json   write machine readable results to the file instead of stdout
+ *      --quick  fewer iterations, used by ctest to keep the benchmarks building and running
+ */
+#include "bench_report.h"
+#include <string.h>
+
+int main(int argc, char** argv){
+    const char* json_path = NULL;
+    bool quick = false;
+
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--json") == 0 && i + 1 < argc){
+            json_path = argv[++i];
+        }else if(strcmp(argv[i], "--quick") == 0){
+            quick = true;
+        }else{
+            fprintf(stderr, "usage: %s [--json results.json] [--quick]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Bench_Report report;
+    bench_drivers(report, quick);
+    bench_low_power(report, quick);
+    bench_filters(report, quick);
+    bench_telemetry(report, quick);
+
+    if(json_path == NULL){
+        report.write_json(stdout);
+        return 0;
+    }
+
+    FILE* out = fopen(json_path, "w");
+    if(out == NULL){
+        fprintf(stderr, "unable to open %s\n", json_path);
+        return 1;
+    }
+    report.write_json(out);
+    fclose(out);
+    report.write_summary(stdout);
+    return 0;
+}
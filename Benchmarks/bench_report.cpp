@@ -0,0 +1,53 @@
+/*
+ * Collects benchmark results and writes them as JSON
+ */
+#include "bench_report.h"
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+void Bench_Report::add(const std::string& name, double value, const std::string& unit, Bench_Source source){
+    Bench_Result r;
+    r.name = name;
+    r.value = value;
+    r.unit = unit;
+    r.source = source;
+    results.push_back(r);
+}
+
+/*
+ * Names and units are plain ASCII chosen by the suites, so no escaping is needed
+ */
+void Bench_Report::write_json(FILE* out) const {
+    fprintf(out, "{\n  \"suite\": \"rp2040_libraries\",\n  \"format\": 1,\n  \"results\": [\n");
+    for(size_t i = 0; i < results.size(); i++){
+        const Bench_Result& r = results[i];
+        fprintf(out, "    {\"name\": \"%s\", \"value\": %.6g, \"unit\": \"%s\", \"source\": \"%s\"}%s\n",
+                r.name.c_str(), r.value, r.unit.c_str(), r.source == BENCH_SIM ? "sim" : "host",
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+void Bench_Report::write_summary(FILE* out) const {
+    for(size_t i = 0; i < results.size(); i++){
+        const Bench_Result& r = results[i];
+        fprintf(out, "%-52s %14.6g %-12s %s\n", r.name.c_str(), r.value, r.unit.c_str(),
+                r.source == BENCH_SIM ? "" : "(host)");
+    }
+}
+
+uint64_t bench_host_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t bench_host_cycles(void){
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,58 @@
+/*
+ * Collects benchmark results and writes them as JSON so runs can be diffed between versions.
+ *  Results measured on the simulated board are deterministic, results timed on the host CPU are
+ *  marked "host" and will vary between machines.
+ */
+#ifndef BENCH_REPORT_H
+#define BENCH_REPORT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+enum Bench_Source {BENCH_SIM, BENCH_HOST};
+
+struct Bench_Result {
+    std::string name;   // slash separated, ex. "hdc1080/read_both/14bit/latency"
+    double value;
+    std::string unit;
+    Bench_Source source;
+};
+
+class Bench_Report {
+    private:
+        std::vector<Bench_Result> results;
+
+    public:
+        void add(const std::string& name, double value, const std::string& unit, Bench_Source source);
+        void write_json(FILE* out) const;
+        void write_summary(FILE* out) const;    // aligned plain text table
+};
+
+uint64_t bench_host_ns(void);       // monotonic host clock
+uint64_t bench_host_cycles(void);   // host CPU cycle counter, 0 where there is none
+
+/*
+ * Run fn reps times and return the fastest run in host ns, the minimum is the most repeatable
+ */
+template<typename Fn>
+uint64_t bench_host_best_ns(int reps, Fn fn){
+    uint64_t best = UINT64_MAX;
+    for(int r = 0; r < reps; r++){
+        uint64_t start = bench_host_ns();
+        fn();
+        uint64_t elapsed = bench_host_ns() - start;
+        if(elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+// benchmark suites, each adds its results to the report
+void bench_drivers(Bench_Report& report, bool quick);
+void bench_low_power(Bench_Report& report, bool quick);
+void bench_filters(Bench_Report& report, bool quick);
+void bench_telemetry(Bench_Report& report, bool quick);
+
+#endif
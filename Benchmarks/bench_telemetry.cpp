@@ -0,0 +1,62 @@
+/*
+ * Cost of exporting a sample: the old printf("%f") text line against a binary telemetry frame.
+ *  Formatting time is measured on the host CPU, bytes and writes per record are exact. With stdio
+ *  over USB CDC every flushed line is its own USB transfer, the telemetry sender fills a 64 byte
+ *  packet before it writes.
+ */
+#include "bench_report.h"
+#include "sim.h"
+#include "telemetry.h"
+
+struct Sink_Count {
+    uint64_t bytes;
+    uint64_t writes;
+};
+
+static void count_write(const uint8_t* data, size_t len, void* ctx){
+    (void)data;
+    Sink_Count* s = (Sink_Count*)ctx;
+    s->bytes += len;
+    s->writes++;
+}
+
+static uint16_t sample_code(uint32_t i){
+    return (uint16_t)(25000 + (i * 2654435761u >> 26));
+}
+
+void bench_telemetry(Bench_Report& report, bool quick){
+    const int records = quick ? 1000 : 200000;
+    sim_reset();
+
+    // what the application printed: time, celsius and %RH as text, one line per sample
+    uint64_t text_bytes = 0;
+    volatile char sink = 0;
+    uint64_t text_ns = bench_host_best_ns(5, [&](){
+        char line[64];
+        text_bytes = 0;
+        for(int i = 0; i < records; i++){
+            float c = sample_code(i) / 65536.0f * 165.0f - 40.0f;
+            float rh = sample_code(i + 1) / 65536.0f * 100.0f;
+            int n = snprintf(line, sizeof(line), "%lu,%f,%f\n", (unsigned long)time_us_32(), c, rh);
+            text_bytes += n;
+            sink = line[0];
+        }
+    });
+    (void)sink;
+
+    Sink_Count counted = {0, 0};
+    uint64_t frame_ns = bench_host_best_ns(5, [&](){
+        counted.bytes = counted.writes = 0;
+        Telemetry tlm(count_write, &counted);
+        for(int i = 0; i < records; i++)
+            tlm.send_sample(sample_code(i), sample_code(i + 1));
+        tlm.flush();
+    });
+
+    report.add("telemetry/text_line/time", (double)text_ns / records, "ns/record", BENCH_HOST);
+    report.add("telemetry/text_line/bytes", (double)text_bytes / records, "bytes/record", BENCH_HOST);
+    report.add("telemetry/text_line/writes", 1000.0, "writes/1000 records", BENCH_HOST);
+    report.add("telemetry/binary_frame/time", (double)frame_ns / records, "ns/record", BENCH_HOST);
+    report.add("telemetry/binary_frame/bytes", (double)counted.bytes / records, "bytes/record", BENCH_HOST);
+    report.add("telemetry/binary_frame/writes", counted.writes * 1000.0 / records, "writes/1000 records", BENCH_HOST);
+}
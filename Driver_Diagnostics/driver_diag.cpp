@@ -0,0 +1,104 @@
+/*
+ * Driver diagnostics: per-device event counters and a fixed-size binary event log.
+ */
+#include "driver_diag.h"
+#include <hardware/sync.h>
+#include <hardware/timer.h>
+
+static const uint32_t RING_MASK = DIAG_EVENT_RING_SIZE - 1;
+
+Driver_Diag::Driver_Diag(){
+    reset();
+}
+
+/*
+ * Count an event and append it to the event log. Overwrites the oldest entry when the log is full.
+ */
+void Driver_Diag::record(Diag_Event event, uint8_t reg, int result){
+    count[event] = count[event] + 1;
+
+    uint32_t seq = head;
+    Diag_Record* rec = &ring[seq & RING_MASK];
+    rec->time_us = time_us_32();
+    rec->event = (uint8_t)event;
+    rec->reg = reg;
+    rec->result = (int16_t)result;
+
+    __dmb(); // entry must be visible before it is published
+    head = seq + 1;
+}
+
+/*
+ * Count an event without logging it, used for events that happen on every call (samples, config writes)
+ *  so they don't push errors out of the log.
+ */
+void Driver_Diag::increment(Diag_Event event){
+    count[event] = count[event] + 1;
+}
+
+uint32_t Driver_Diag::get_count(Diag_Event event) const {
+    return count[event];
+}
+
+Diag_Counters Driver_Diag::counters() const {
+    Diag_Counters c;
+    c.nacks = count[DIAG_NACK];
+    c.timeouts = count[DIAG_TIMEOUT];
+    c.retries = count[DIAG_RETRY];
+    c.config_writes = count[DIAG_CONFIG_WRITE];
+    c.samples = count[DIAG_SAMPLE];
+    c.bad_args = count[DIAG_BAD_ARG];
+    c.events_logged = head;
+    return c;
+}
+
+/*
+ * Copy up to max of the newest events into dst, oldest first. Safe to call from another core or
+ *  an interrupt while the owner keeps logging: entries overwritten during the copy are dropped.
+ *  The slot the writer fills next may be half written at any time, so at most
+ *  DIAG_EVENT_RING_SIZE - 1 events are returned.
+ */
+size_t Driver_Diag::copy_events(Diag_Record* dst, size_t max) const {
+    if(dst == NULL || max == 0)
+        return 0;
+
+    uint32_t start_head = head;
+    __dmb();
+
+    uint32_t n = start_head < DIAG_EVENT_RING_SIZE - 1 ? start_head : DIAG_EVENT_RING_SIZE - 1;
+    if(n > max)
+        n = max;
+    uint32_t first = start_head - n; // sequence number of the first entry copied
+
+    for(uint32_t i = 0; i < n; i++){
+        const Diag_Record* rec = &ring[(first + i) & RING_MASK];
+        dst[i].time_us = rec->time_us;
+        dst[i].event = rec->event;
+        dst[i].reg = rec->reg;
+        dst[i].result = rec->result;
+    }
+
+    __dmb();
+    uint32_t end_head = head;
+
+    // the writer may be filling the slot of sequence end_head, which held end_head - SIZE, so only
+    // entries from end_head - SIZE + 1 on are intact
+    if(end_head - first > DIAG_EVENT_RING_SIZE - 1){
+        uint32_t lost = end_head - first - (DIAG_EVENT_RING_SIZE - 1);
+        if(lost >= n)
+            return 0;
+        for(uint32_t i = 0; i < n - lost; i++)
+            dst[i] = dst[i + lost];
+        n -= lost;
+    }
+    return n;
+}
+
+/*
+ * Clear the counters and the log
+ */
+void Driver_Diag::reset(void){
+    for(int i = 0; i < DIAG_EVENT_COUNT; i++)
+        count[i] = 0;
+    head = 0;
+}
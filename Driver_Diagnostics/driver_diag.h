@@ -0,0 +1,76 @@
+/*
+ * Driver diagnostics: per-device event counters and a fixed-size binary event log.
+ *  Replaces printf() error reporting in the drivers. Recording an event is a handful of
+ *  loads and stores, never blocks, and does not depend on stdio. The application decides
+ *  when (and how) to dump the counters and the event log.
+ */
+#ifndef DRIVER_DIAG_H
+#define DRIVER_DIAG_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef DIAG_EVENT_RING_SIZE
+#define DIAG_EVENT_RING_SIZE 8 /*number of events kept per device (8 bytes each), must be a power of two*/
+#endif
+
+static_assert(DIAG_EVENT_RING_SIZE >= 2 && (DIAG_EVENT_RING_SIZE & (DIAG_EVENT_RING_SIZE - 1)) == 0,
+    "DIAG_EVENT_RING_SIZE must be a power of two, at least 2");
+
+enum Diag_Event {DIAG_NACK=0,       /*address or data byte not acknowledged*/
+            DIAG_TIMEOUT=1,         /*bus transaction did not finish in time*/
+            DIAG_RETRY=2,           /*transaction repeated after a failure*/
+            DIAG_CONFIG_WRITE=3,    /*configuration register written*/
+            DIAG_SAMPLE=4,          /*measurement read successfully*/
+            DIAG_BAD_ARG=5,         /*invalid argument passed to the driver*/
+            DIAG_EVENT_COUNT=6};
+
+/*
+ * One entry of the event log, 8 bytes so the whole log can be copied out as a binary blob
+ */
+struct Diag_Record {
+    uint32_t time_us;   // lower 32 bits of the timer when the event happened
+    uint8_t event;      // Diag_Event
+    uint8_t reg;        // register pointer (or other driver specific tag) the event refers to
+    int16_t result;     // SDK return code, ex. PICO_ERROR_GENERIC
+};
+
+/*
+ * Copy of the counters taken at one point in time
+ */
+struct Diag_Counters {
+    uint32_t nacks;
+    uint32_t timeouts;
+    uint32_t retries;
+    uint32_t config_writes;
+    uint32_t samples;
+    uint32_t bad_args;
+    uint32_t events_logged; // total events ever written to the log, including overwritten ones
+};
+
+/*
+ * Counters and event log for one device. Each device object is owned by one core/context, which
+ *  is the only writer. The RP2040 (Cortex-M0+) has no atomic read-modify-write instructions, so
+ *  the counters are single-writer 32 bit words: any core can read them without tearing.
+ *  The event log is a lock-free overwrite ring, readers detect and drop entries that were
+ *  overwritten while they were copying.
+ */
+class Driver_Diag {
+    private:
+        volatile uint32_t count[DIAG_EVENT_COUNT];
+        volatile uint32_t head;     // sequence number of the next event to write
+        Diag_Record ring[DIAG_EVENT_RING_SIZE];
+
+    public:
+        Driver_Diag();
+
+        void record(Diag_Event, uint8_t reg, int result);   // count the event and append it to the log
+        void increment(Diag_Event);                         // count the event without logging it (frequent events)
+
+        uint32_t get_count(Diag_Event) const;   // read a single counter
+        Diag_Counters counters() const;         // read all counters
+        size_t copy_events(Diag_Record* dst, size_t max) const; // copy newest events (oldest first, at most DIAG_EVENT_RING_SIZE - 1), returns number copied
+        void reset(void);                       // clear counters and log, call from the owning context only
+};
+
+#endif
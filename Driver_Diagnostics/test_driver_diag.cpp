@@ -0,0 +1,110 @@
+/*
+ * Tests for the diagnostics counters and event log
+ */
+#include "sim_test.h"
+#include "sim.h"
+#include "driver_diag.h"
+#include <atomic>
+#include <thread>
+
+static void test_counters(){
+    sim_reset();
+    Driver_Diag diag;
+    diag.record(DIAG_NACK, 0x01, -2);
+    diag.record(DIAG_NACK, 0x01, -2);
+    diag.increment(DIAG_SAMPLE);
+    diag.record(DIAG_TIMEOUT, 0x02, -1);
+
+    Diag_Counters c = diag.counters();
+    CHECK_EQ(c.nacks, 2);
+    CHECK_EQ(c.timeouts, 1);
+    CHECK_EQ(c.samples, 1);
+    CHECK_EQ(c.events_logged, 3);      // increment() counts without logging
+
+    diag.reset();
+    CHECK_EQ(diag.counters().nacks, 0);
+    Diag_Record out[4];
+    CHECK_EQ(diag.copy_events(out, 4), 0);
+}
+
+static void test_ring_overwrite(){
+    sim_reset();
+    Driver_Diag diag;
+    const int total = DIAG_EVENT_RING_SIZE + 10;
+    for(int i = 0; i < total; i++){
+        sim_charge(SIM_CYCLES_PER_US);
+        diag.record(DIAG_RETRY, (uint8_t)i, i);
+    }
+
+    Diag_Record out[DIAG_EVENT_RING_SIZE + 8];
+    size_t n = diag.copy_events(out, DIAG_EVENT_RING_SIZE + 8);
+    CHECK_EQ(n, DIAG_EVENT_RING_SIZE - 1);     // the oldest were overwritten, the next slot to write is never returned
+    CHECK_EQ(out[0].result, total - DIAG_EVENT_RING_SIZE + 1);
+    CHECK_EQ(out[n - 1].result, total - 1);
+    CHECK(out[0].time_us < out[n - 1].time_us);
+    CHECK_EQ(diag.counters().events_logged, total);
+}
+
+/*
+ * A short copy gets the newest events, still oldest first
+ */
+static void test_copy_window(){
+    sim_reset();
+    Driver_Diag diag;
+    for(int i = 0; i < 5; i++)
+        diag.record(DIAG_NACK, 0, i);
+
+    Diag_Record out[3];
+    CHECK_EQ(diag.copy_events(out, 3), 3);
+    CHECK_EQ(out[0].result, 2);
+    CHECK_EQ(out[2].result, 4);
+    CHECK_EQ(diag.copy_events(NULL, 3), 0);
+    CHECK_EQ(diag.copy_events(out, 0), 0);
+}
+
+/*
+ * Reader copying while the owner keeps logging: every copy must be a run of consecutive events,
+ *  entries overwritten during the copy are dropped instead of returned torn
+ */
+static void test_copy_while_logging(){
+    sim_reset();
+    static Driver_Diag diag;
+    diag.reset();
+    const int total = 200000;
+    static std::atomic<bool> go;
+    go = false;
+
+    std::thread writer([](){
+        while(!go)
+            ;
+        for(int i = 0; i < total; i++)
+            diag.record(DIAG_RETRY, (uint8_t)i, (int16_t)i);
+    });
+
+    int copies = 0, bad = 0;
+    Diag_Record out[DIAG_EVENT_RING_SIZE];
+    go = true;
+    while(diag.counters().events_logged < (uint32_t)total){
+        size_t n = diag.copy_events(out, DIAG_EVENT_RING_SIZE);
+        for(size_t i = 1; i < n; i++){
+            if((int16_t)(out[i].result - out[i - 1].result) != 1 || (uint8_t)(out[i].reg - out[i - 1].reg) != 1)
+                bad++;
+        }
+        copies++;
+    }
+    writer.join();
+
+    CHECK_EQ(bad, 0);
+    CHECK(copies > 0);
+    size_t n = diag.copy_events(out, DIAG_EVENT_RING_SIZE);
+    CHECK_EQ(n, DIAG_EVENT_RING_SIZE - 1);
+    CHECK_EQ(out[n - 1].result, (int16_t)(total - 1));
+}
+
+int main(){
+    RUN_TEST(test_counters);
+    RUN_TEST(test_ring_overwrite);
+    RUN_TEST(test_copy_window);
+    RUN_TEST(test_copy_while_logging);
+    return TEST_RESULT();
+}
@@ -0,0 +1,140 @@
+/*
+ * Opt-in hot path instrumentation for the drivers, see driver_instrument.h
+ */
+#include "driver_instrument.h"
+
+#if DRIVER_INSTRUMENTATION
+
+#include <pico.h>
+#include <hardware/timer.h>
+#if defined(DRIVER_INSTRUMENTATION_SYSTICK)
+#include <hardware/clocks.h>
+#include <hardware/structs/systick.h>
+
+#define SYSTICK_RELOAD 0x00FFFFFF   /*free running over the full 24 bit range*/
+
+// SysTick is private to each core, so is its state. Each entry is written by its own core only.
+static volatile bool systick_started[2];    // instr_init() set up SysTick on this core
+static volatile bool systick_busy[2];       // SysTick runs with someone else's period on this core
+#endif
+
+static Instr_Histogram histograms[INSTR_OP_COUNT];
+
+static const char* const OP_NAMES[INSTR_OP_COUNT] = {
+    "i2c_transaction",
+    "conversion_wait",
+    "hdc_read",
+    "hdc_read_both",
+    "step",
+    "display_refresh"
+};
+
+#if defined(DRIVER_INSTRUMENTATION_SYSTICK)
+/*
+ * The histograms are shared by both cores, so both must count in the same unit: SysTick is only
+ *  used while no core found it taken, otherwise every core uses the timer.
+ */
+static bool use_systick(void){
+    return systick_started[get_core_num()] && !systick_busy[0] && !systick_busy[1];
+}
+#endif
+
+/*
+ * The 1MHz timer needs no setup. SysTick is a 24 bit down counter private to each core, so every core
+ *  that records needs to start its own. If it is already running with another reload value it
+ *  belongs to an RTOS (ex. the FreeRTOS scheduler tick) and is left alone, the timer is used instead,
+ *  on both cores. Call it on every core before either records.
+ */
+void instr_init(void){
+#if defined(DRIVER_INSTRUMENTATION_SYSTICK)
+    uint core = get_core_num();
+    if((systick_hw->csr & 1) && systick_hw->rvr != SYSTICK_RELOAD){
+        systick_started[core] = false;
+        systick_busy[core] = true;
+        return;
+    }
+    systick_hw->csr = 0;
+    systick_hw->rvr = SYSTICK_RELOAD;
+    systick_hw->cvr = 0;            // any write clears the counter
+    systick_hw->csr = 0x5;          // enable, clocked from the processor clock, no interrupt
+    systick_busy[core] = false;
+    systick_started[core] = true;
+#endif
+}
+
+uint32_t instr_now(void){
+#if defined(DRIVER_INSTRUMENTATION_SYSTICK)
+    if(use_systick())
+        return ~systick_hw->cvr & SYSTICK_RELOAD; // invert so the count goes up
+#endif
+    return time_us_32();
+}
+
+uint32_t instr_elapsed(uint32_t start){
+#if defined(DRIVER_INSTRUMENTATION_SYSTICK)
+    if(use_systick())
+        return (instr_now() - start) & SYSTICK_RELOAD;
+#endif
+    return instr_now() - start;
+}
+
+uint32_t instr_ticks_per_us(void){
+#if defined(DRIVER_INSTRUMENTATION_SYSTICK)
+    if(use_systick())
+        return clock_get_hz(clk_sys) / 1000000;
+#endif
+    return 1;
+}
+
+/*
+ * Add one sample. Each operation should only be recorded from one core at a time.
+ */
+void instr_record(Instr_Op op, uint32_t ticks){
+    Instr_Histogram* h = &histograms[op];
+
+    int b = ticks == 0 ? 0 : 32 - __builtin_clz(ticks);
+    if(b >= INSTR_BUCKETS)
+        b = INSTR_BUCKETS - 1;
+    h->bucket[b]++;
+
+    if(h->count == 0 || ticks < h->min)
+        h->min = ticks;
+    if(ticks > h->max)
+        h->max = ticks;
+    h->total += ticks;
+    h->count++;
+}
+
+Instr_Histogram instr_histogram(Instr_Op op){
+    return histograms[op];
+}
+
+uint32_t instr_percentile(const Instr_Histogram* h, uint32_t pct){
+    if(h == NULL || h->count == 0)
+        return 0;
+
+    uint64_t target = ((uint64_t)h->count * pct + 99) / 100; // rank of the sample we want
+    if(target == 0)
+        target = 1;
+
+    uint64_t seen = 0;
+    for(int b = 0; b < INSTR_BUCKETS; b++){
+        seen += h->bucket[b];
+        if(seen >= target){
+            uint32_t upper = b == 0 ? 0 : (uint32_t)((1ull << b) - 1);
+            return upper < h->max ? upper : h->max;
+        }
+    }
+    return h->max;
+}
+
+const char* instr_op_name(Instr_Op op){
+    return OP_NAMES[op];
+}
+
+void instr_reset(void){
+    for(int i = 0; i < INSTR_OP_COUNT; i++)
+        histograms[i] = Instr_Histogram();
+}
+
+#endif
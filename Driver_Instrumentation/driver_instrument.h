@@ -0,0 +1,75 @@
+/*
+ * Opt-in hot path instrumentation for the drivers. Timestamps entry and exit of driver operations
+ *  and keeps a fixed-bucket latency histogram per operation.
+ *
+ *  Build with -DDRIVER_INSTRUMENTATION=1 to enable. Without it INSTR_SCOPE() expands to nothing and
+ *  the drivers compile exactly as before.
+ *
+ *  Clock: the 1MHz system timer by default, it is shared and needs no setup. Define
+ *  DRIVER_INSTRUMENTATION_SYSTICK for processor cycle resolution from SysTick (24 bit, operations
+ *  up to ~130ms). SysTick is only taken when nothing else runs it, an RTOS tick is left alone and
+ *  then both cores use the timer, so the histograms stay in one unit.
+ *  The host simulator models both, so histograms from the board and the simulator can be compared.
+ */
+#ifndef DRIVER_INSTRUMENT_H
+#define DRIVER_INSTRUMENT_H
+
+#include <stdint.h>
+
+#define INSTR_BUCKETS 32 /*bucket i counts latencies in [2^(i-1), 2^i) ticks, bucket 0 counts 0 ticks*/
+
+enum Instr_Op {INSTR_I2C_TRANSACTION=0,    /*one I2C read or write, including retries*/
+            INSTR_CONVERSION_WAIT=1,        /*waiting for the HDC1080 to finish a conversion*/
+            INSTR_HDC_READ=2,               /*HDC1080 single temperature or humidity read*/
+            INSTR_HDC_READ_BOTH=3,          /*HDC1080::read_both() start to finish*/
+            INSTR_STEP=4,                   /*SM_28BYJ_48::step()*/
+            INSTR_DISPLAY_REFRESH=5,        /*drawing one 7 segment digit*/
+            INSTR_OP_COUNT=6};
+
+/*
+ * Latency distribution for one operation, all values in ticks (see instr_ticks_per_us())
+ */
+struct Instr_Histogram {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t bucket[INSTR_BUCKETS];
+};
+
+#if DRIVER_INSTRUMENTATION
+
+void instr_init(void);                      // start the tick source, call once on every core that records, before recording
+uint32_t instr_now(void);                   // current tick count, wraps
+uint32_t instr_elapsed(uint32_t start);     // ticks since start, handles wrap of the tick source
+uint32_t instr_ticks_per_us(void);          // tick rate, to convert histogram values to time
+void instr_record(Instr_Op, uint32_t ticks);// add one latency sample to the histogram
+
+Instr_Histogram instr_histogram(Instr_Op);  // copy of the histogram for one operation
+uint32_t instr_percentile(const Instr_Histogram*, uint32_t pct); // upper bound (ticks) of the bucket holding the pct-th percentile
+const char* instr_op_name(Instr_Op);        // short name for reports, ex. "step"
+void instr_reset(void);                     // clear all histograms
+
+/*
+ * Records the lifetime of the object, so early returns in the drivers are measured too
+ */
+class Instr_Scope {
+    private:
+        Instr_Op op;
+        uint32_t start;
+    public:
+        Instr_Scope(Instr_Op o) : op(o), start(instr_now()) {}
+        ~Instr_Scope(){ instr_record(op, instr_elapsed(start)); }
+};
+
+#define INSTR_CONCAT_(a, b) a##b
+#define INSTR_CONCAT(a, b) INSTR_CONCAT_(a, b)
+#define INSTR_SCOPE(op) Instr_Scope INSTR_CONCAT(instr_scope_, __LINE__)(op)
+
+#else
+
+#define INSTR_SCOPE(op) do {} while(0)
+
+#endif
+
+#endif
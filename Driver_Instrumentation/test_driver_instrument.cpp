@@ -0,0 +1,126 @@
+/*
+ * Tests for the latency histograms and the tick sources
+ */
+#include "sim_test.h"
+#include "sim.h"
+#include "driver_instrument.h"
+#include <hardware/structs/systick.h>
+
+static void test_buckets(){
+    sim_reset();
+    instr_reset();
+    instr_record(INSTR_STEP, 0);
+    instr_record(INSTR_STEP, 1);
+    instr_record(INSTR_STEP, 2);
+    instr_record(INSTR_STEP, 3);
+    instr_record(INSTR_STEP, 4);
+    instr_record(INSTR_STEP, 0xFFFFFFFFu);
+
+    Instr_Histogram h = instr_histogram(INSTR_STEP);
+    CHECK_EQ(h.count, 6);
+    CHECK_EQ(h.min, 0);
+    CHECK_EQ(h.max, 0xFFFFFFFFu);
+    CHECK_EQ(h.bucket[0], 1);           // 0
+    CHECK_EQ(h.bucket[1], 1);           // [1, 2)
+    CHECK_EQ(h.bucket[2], 2);           // [2, 4)
+    CHECK_EQ(h.bucket[3], 1);           // [4, 8)
+    CHECK_EQ(h.bucket[INSTR_BUCKETS - 1], 1); // everything too large lands in the last bucket
+    CHECK_EQ(instr_histogram(INSTR_HDC_READ).count, 0);
+
+    instr_reset();
+    CHECK_EQ(instr_histogram(INSTR_STEP).count, 0);
+}
+
+static void test_percentile(){
+    sim_reset();
+    instr_reset();
+    for(int i = 0; i < 90; i++)
+        instr_record(INSTR_I2C_TRANSACTION, 100);   // bucket 7, [64, 128)
+    for(int i = 0; i < 10; i++)
+        instr_record(INSTR_I2C_TRANSACTION, 1000);  // bucket 10, [512, 1024)
+
+    Instr_Histogram h = instr_histogram(INSTR_I2C_TRANSACTION);
+    CHECK_EQ(instr_percentile(&h, 50), 127);
+    CHECK_EQ(instr_percentile(&h, 90), 127);
+    CHECK_EQ(instr_percentile(&h, 91), 1000);       // bucket bound 1023 is capped at the max seen
+    CHECK_EQ(instr_percentile(&h, 100), 1000);
+    CHECK_EQ(instr_percentile(&h, 0), 127);         // the smallest sample's bucket
+
+    Instr_Histogram empty = Instr_Histogram();
+    CHECK_EQ(instr_percentile(&empty, 50), 0);
+    CHECK_EQ(instr_percentile(NULL, 50), 0);
+}
+
+static void test_scope(){
+    sim_reset();
+    instr_init();
+    instr_reset();
+    CHECK_EQ(instr_ticks_per_us(), SIM_CYCLES_PER_US);
+    {
+        INSTR_SCOPE(INSTR_DISPLAY_REFRESH);
+        sim_charge(1000);
+    }
+    Instr_Histogram h = instr_histogram(INSTR_DISPLAY_REFRESH);
+    CHECK_EQ(h.count, 1);
+    CHECK(h.min >= 1000 && h.min < 1100);
+}
+
+static void test_systick_in_use(){
+    // an RTOS already runs SysTick as its tick interrupt, instr_init() must not touch it
+    sim_reset();
+    systick_hw->rvr = SIM_CYCLES_PER_US * 1000 - 1;
+    systick_hw->csr = 0x7;
+    instr_init();
+    CHECK_EQ(systick_hw->rvr, SIM_CYCLES_PER_US * 1000 - 1);
+    CHECK_EQ(systick_hw->csr, 0x7);
+    CHECK_EQ(instr_ticks_per_us(), 1);
+
+    uint32_t start = instr_now();
+    sim_charge(SIM_CYCLES_PER_US * 5000);
+    CHECK_EQ(instr_elapsed(start), 5000);   // timer microseconds, past a SysTick period
+
+    // free again after a reset, SysTick is taken back
+    sim_reset();
+    instr_init();
+    CHECK_EQ(instr_ticks_per_us(), SIM_CYCLES_PER_US);
+}
+
+/*
+ * Core 1 runs an RTOS tick, core 0 has SysTick free. The histograms are shared, so both cores must
+ *  fall back to the timer. The simulator has one set of SysTick registers, each core's are set up
+ *  before its instr_init().
+ */
+static void test_systick_in_use_on_other_core(){
+    sim_reset();
+    sim_set_core(1);
+    systick_hw->rvr = SIM_CYCLES_PER_US * 1000 - 1;
+    systick_hw->csr = 0x7;
+    instr_init();
+    CHECK_EQ(instr_ticks_per_us(), 1);
+
+    sim_set_core(0);
+    systick_hw->csr = 0;
+    instr_init();
+    CHECK_EQ(systick_hw->csr, 0x5);         // started, but not used while core 1 can't
+    CHECK_EQ(instr_ticks_per_us(), 1);
+    uint32_t start = instr_now();
+    sim_charge(SIM_CYCLES_PER_US * 300);
+    CHECK_EQ(instr_elapsed(start), 300);
+
+    // core 1's RTOS is gone and it takes SysTick too: cycles on both cores
+    sim_set_core(1);
+    systick_hw->csr = 0;
+    instr_init();
+    CHECK_EQ(instr_ticks_per_us(), SIM_CYCLES_PER_US);
+    sim_set_core(0);
+    CHECK_EQ(instr_ticks_per_us(), SIM_CYCLES_PER_US);
+}
+
+int main(){
+    RUN_TEST(test_buckets);
+    RUN_TEST(test_percentile);
+    RUN_TEST(test_scope);
+    RUN_TEST(test_systick_in_use);
+    RUN_TEST(test_systick_in_use_on_other_core);
+    return TEST_RESULT();
+}
@@ -0,0 +1,179 @@
+/*
+ * Dual-core partitioning, see dual_core.h
+ */
+#include "dual_core.h"
+#include <pico/stdlib.h>
+#include <pico/multicore.h>
+#include <hardware/sync.h>
+
+static RT_Core* volatile core1_rt; // handed to core1_entry(), the FIFO stays free for the lockout handler
+
+Core_Load::Core_Load(){
+    busy_start_us = 0;
+    reset();
+}
+
+void Core_Load::busy_begin(void){
+    busy_start_us = time_us_32();
+}
+
+void Core_Load::busy_end(void){
+    add_busy(time_us_32() - busy_start_us);
+}
+
+void Core_Load::add_busy(uint32_t us){
+    busy_us = busy_us + us;
+}
+
+/*
+ * The window is measured with the 32 bit timer, reset() at least once an hour
+ */
+uint32_t Core_Load::load_permille(void) const {
+    uint32_t busy = busy_us;
+    uint32_t elapsed = time_us_32() - window_start_us;
+    if(elapsed == 0)
+        return 0;
+    uint64_t permille = (uint64_t)busy * 1000 / elapsed;
+    return permille > 1000 ? 1000 : (uint32_t)permille;
+}
+
+void Core_Load::reset(void){
+    busy_us = 0;
+    window_start_us = time_us_32();
+}
+
+RT_Core::RT_Core(uint32_t tick_us){
+    this->tick_us = tick_us;
+    task_count = 0;
+    on_command = NULL;
+    command_ctx = NULL;
+    next_tick_us = time_us_64();
+    ticks = 0;
+    overruns = 0;
+    max_busy_us = 0;
+    commands = 0;
+    reset_requested = false;
+}
+
+bool RT_Core::add_task(rt_task_fn fn, void* ctx, uint16_t period_ticks){
+    if(task_count == RT_MAX_TASKS || fn == NULL || period_ticks == 0)
+        return false;
+    RT_Task* t = &tasks[task_count++];
+    t->fn = fn;
+    t->ctx = ctx;
+    t->period_ticks = period_ticks;
+    t->countdown = 1; // everything runs on the first tick
+    return true;
+}
+
+void RT_Core::set_command_handler(rt_command_fn fn, void* ctx){
+    on_command = fn;
+    command_ctx = ctx;
+}
+
+void RT_Core::core1_entry(void){
+    __dmb();
+    core1_rt->run();
+}
+
+void RT_Core::start(void){
+    core1_rt = this;
+    __dmb();
+    multicore_launch_core1(core1_entry);
+}
+
+/*
+ * Core 0 can pause core 1 for flash writes from now on, the lockout handler runs from RAM
+ */
+void RT_Core::begin_core1(void){
+    multicore_lockout_victim_init();
+    next_tick_us = time_us_64();
+    load.reset();
+}
+
+void RT_Core::run(void){
+    begin_core1();
+    while(true){
+        busy_wait_until(next_tick_us);
+        run_tick();
+    }
+}
+
+/*
+ * Commands, then due tasks, then accounting. If the work ran into the next tick (or the tick
+ *  started late) it counts as an overrun and the missed ticks are skipped, the schedule stays on
+ *  the tick grid instead of running a burst of late ticks.
+ */
+void RT_Core::run_tick(void){
+    uint32_t start = time_us_32();
+    if(reset_requested){
+        ticks = 0;
+        overruns = 0;
+        max_busy_us = 0;
+        commands = 0;
+        load.reset();
+        reset_requested = false;
+    }
+
+    uint32_t word;
+    while(command_queue.pop(&word)){
+        commands = commands + 1;
+        if(on_command != NULL)
+            on_command((uint8_t)(word >> 24), (int32_t)(word << 8) >> 8, command_ctx);
+    }
+
+    for(uint8_t i = 0; i < task_count; i++){
+        RT_Task* t = &tasks[i];
+        if(--t->countdown == 0){
+            t->countdown = t->period_ticks;
+            t->fn(t->ctx);
+        }
+    }
+
+    uint32_t busy = time_us_32() - start;
+    load.add_busy(busy);
+    if(busy > max_busy_us)
+        max_busy_us = busy;
+    ticks = ticks + 1;
+
+    next_tick_us += tick_us;
+    uint64_t now = time_us_64();
+    if(now > next_tick_us){
+        overruns = overruns + 1;
+        next_tick_us += ((now - next_tick_us) / tick_us + 1) * tick_us;
+    }
+}
+
+uint64_t RT_Core::get_next_tick_us(void) const {
+    return next_tick_us;
+}
+
+uint32_t RT_Core::get_tick_us(void) const {
+    return tick_us;
+}
+
+RT_Stats RT_Core::stats(void) const {
+    RT_Stats s;
+    s.ticks = ticks;
+    s.overruns = overruns;
+    s.max_busy_us = max_busy_us;
+    s.commands = commands;
+    s.load_permille = load.load_permille();
+    return s;
+}
+
+void RT_Core::reset_stats(void){
+    reset_requested = true;
+}
+
+/*
+ * Command word: command in the top 8 bits, argument in the low 24 bits (sign extended on receive)
+ */
+bool RT_Core::send_command(uint8_t command, int32_t arg){
+    return command_queue.push(((uint32_t)command << 24) | ((uint32_t)arg & 0x00FFFFFF));
+}
+
+bool rt_send_command(uint8_t command, int32_t arg){
+    RT_Core* rt = core1_rt;
+    return rt != NULL && rt->send_command(command, arg);
+}
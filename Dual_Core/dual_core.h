@@ -0,0 +1,110 @@
+/*
+ * Dual-core partitioning: real-time output work (stepper steps, 7 segment multiplexing, switch
+ *  scanning) runs from a fixed tick on core 1, blocking sensor I/O stays on core 0. A 15ms HDC1080
+ *  read on core 0 can then no longer delay a step.
+ *
+ *  Core 0 -> core 1 commands and core 1 -> core 0 readings and events all go through SPSC_Queue
+ *  (spsc_queue.h), no lock is taken.
+ *
+ *  The tick loop busy-waits on core 1 for the lowest jitter, core 1 is dedicated to it. It runs
+ *  from flash, so core 1 registers as a lockout victim and leaves the SIO FIFO to the lockout
+ *  handler: wrap flash writes on core 0 (ex. Flash_Log) in multicore_lockout_start_blocking() and
+ *  multicore_lockout_end_blocking(). Core 1 is paused meanwhile, missed ticks count as overruns.
+ */
+#ifndef DUAL_CORE_H
+#define DUAL_CORE_H
+
+#include <stdint.h>
+#include "spsc_queue.h"
+
+#ifndef RT_MAX_TASKS
+#define RT_MAX_TASKS 8
+#endif
+
+#ifndef RT_COMMAND_QUEUE_SIZE
+#define RT_COMMAND_QUEUE_SIZE 8 /*commands waiting for core 1, must be a power of two*/
+#endif
+
+typedef void (*rt_task_fn)(void* ctx);
+typedef void (*rt_command_fn)(uint8_t command, int32_t arg, void* ctx);
+
+/*
+ * Busy time accounting for one core. Only the owning core writes, any core may read.
+ */
+class Core_Load {
+    private:
+        volatile uint32_t busy_us;          // busy time since window_start_us
+        volatile uint32_t window_start_us;
+        uint32_t busy_start_us;             // set by busy_begin()
+
+    public:
+        Core_Load();
+
+        void busy_begin(void);              // mark the start of work, ex. before a sensor read
+        void busy_end(void);                // and its end
+        void add_busy(uint32_t us);
+        uint32_t load_permille(void) const; // busy share of the time since reset(), 0-1000
+        void reset(void);                   // start a new window, call from the owning core only
+};
+
+/*
+ * Snapshot of the tick loop counters
+ */
+struct RT_Stats {
+    uint32_t ticks;         // ticks run
+    uint32_t overruns;      // ticks whose work ran past the start of the next tick, missed ticks are skipped
+    uint32_t max_busy_us;   // longest tick
+    uint32_t commands;      // commands handled
+    uint32_t load_permille; // core 1 busy share, 0-1000
+};
+
+/*
+ * The core 1 tick loop. Set it up on core 0, then start() it. Tasks run in the order they were
+ *  added, every period_ticks ticks. Each tick starts with the commands waiting in the queue.
+ */
+class RT_Core {
+    private:
+        struct RT_Task {
+            rt_task_fn fn;
+            void* ctx;
+            uint16_t period_ticks;
+            uint16_t countdown;     // ticks until the next run
+        };
+
+        RT_Task tasks[RT_MAX_TASKS];
+        uint8_t task_count;
+        rt_command_fn on_command;
+        void* command_ctx;
+        uint32_t tick_us;
+        uint64_t next_tick_us;      // scheduled start of the next tick
+        SPSC_Queue<uint32_t, RT_COMMAND_QUEUE_SIZE> command_queue; // core 0 pushes, core 1 pops
+
+        volatile uint32_t ticks;    // counters are written by core 1 only
+        volatile uint32_t overruns;
+        volatile uint32_t max_busy_us;
+        volatile uint32_t commands;
+        volatile bool reset_requested;
+        Core_Load load;
+
+        static void core1_entry(void);
+
+    public:
+        RT_Core(uint32_t tick_us);
+
+        bool add_task(rt_task_fn fn, void* ctx, uint16_t period_ticks=1); // false if RT_MAX_TASKS are used, before start() only
+        void set_command_handler(rt_command_fn fn, void* ctx);            // before start() only
+        void start(void);           // launch the tick loop on core 1
+        void run(void);             // the tick loop, never returns
+        void begin_core1(void);     // first thing run() does on core 1, host tests call it directly on the simulated core 1
+        void run_tick(void);        // one tick, called by run(), host tests call it directly on the simulated core 1
+        bool send_command(uint8_t command, int32_t arg); // core 0, arg is 24 bit signed, false (not sent) if the queue is full
+
+        uint64_t get_next_tick_us(void) const;
+        uint32_t get_tick_us(void) const;
+        RT_Stats stats(void) const;     // any core
+        void reset_stats(void);         // any core, takes effect at the next tick
+};
+
+bool rt_send_command(uint8_t command, int32_t arg);  // send_command() to the started RT_Core, false if none is started
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ * Debounced switch scanning for the core 1 tick
+ */
+#include "rt_switches.h"
+#include <pico/stdlib.h>
+
+/*
+ * Configures the pins as inputs, ex. RT_Switches(SWITCHES) for the Vandaluino 3 buttons
+ */
+RT_Switches::RT_Switches(uint32_t mask, uint8_t stable_ticks, bool active_low){
+    this->mask = mask;
+    this->stable_ticks = stable_ticks;
+    this->active_low = active_low;
+    same_count = 0;
+    candidate = 0;
+    state = 0;
+
+    for(uint pin = 0; pin < NUM_BANK0_GPIOS; pin++){
+        if(!(mask & (1u << pin)))
+            continue;
+        gpio_init(pin);
+        gpio_set_dir(pin, GPIO_IN);
+        if(active_low)
+            gpio_pull_up(pin);
+        else
+            gpio_pull_down(pin);
+    }
+}
+
+uint32_t RT_Switches::scan(void){
+    uint32_t raw = gpio_get_all();
+    uint32_t now = (active_low ? ~raw : raw) & mask;
+
+    if(now != candidate){
+        candidate = now; // still bouncing, start over
+        same_count = 0;
+        return 0;
+    }
+    if(same_count < stable_ticks)
+        same_count++;
+    if(same_count < stable_ticks || candidate == state)
+        return 0;
+
+    uint32_t changed = candidate ^ state;
+    state = candidate;
+    return changed;
+}
+
+uint32_t RT_Switches::pressed(void) const {
+    return state;
+}
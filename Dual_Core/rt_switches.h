@@ -0,0 +1,26 @@
+/*
+ * Debounced switch scanning for the core 1 tick. All switches are sampled at once from the SIO
+ *  input register, a change is accepted once the inputs have read the same for stable_ticks scans.
+ */
+#ifndef RT_SWITCHES_H
+#define RT_SWITCHES_H
+
+#include <stdint.h>
+
+class RT_Switches {
+    private:
+        uint32_t mask;          // pins scanned
+        bool active_low;        // pressed reads low, pins get pull ups
+        uint8_t stable_ticks;
+        uint8_t same_count;     // scans the candidate has been stable for
+        uint32_t candidate;     // last raw reading
+        uint32_t state;         // debounced pressed switches
+
+    public:
+        RT_Switches(uint32_t mask, uint8_t stable_ticks=5, bool active_low=true);
+
+        uint32_t scan(void);        // call once per tick, returns the switches whose debounced state changed
+        uint32_t pressed(void) const; // debounced pressed switches, as a pin mask
+};
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * Lock-free single producer, single consumer queue for passing readings and events between the
+ *  two cores. One core only pushes, the other only pops, so no lock or interrupt masking is needed.
+ *
+ *  The Cortex-M0+ has no atomic read-modify-write instructions, so the indexes are only ever
+ *  loaded and stored: each index has exactly one writer. They are volatile 32 bit words (single
+ *  LDR/STR) and __dmb() orders the slot copy against the index update, like Driver_Diag's ring.
+ */
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdint.h>
+#include <hardware/sync.h>
+
+template<typename T, uint32_t N>
+class SPSC_Queue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+
+    private:
+        T slots[N];
+        volatile uint32_t head; // items ever pushed, stored by the producer only
+        volatile uint32_t tail; // items ever popped, stored by the consumer only
+
+    public:
+        SPSC_Queue() : slots(), head(0), tail(0) {}
+
+        /*
+         * Producer side. Returns false if the queue is full, the item is not added.
+         */
+        bool push(const T& item){
+            uint32_t h = head;
+            if(h - tail == N)
+                return false;
+            __dmb(); // the consumer is done reading the slot before it is overwritten
+            slots[h & (N - 1)] = item;
+            __dmb(); // item must be visible before it is published
+            head = h + 1;
+            return true;
+        }
+
+        /*
+         * Consumer side. Returns false if the queue is empty.
+         */
+        bool pop(T* item){
+            uint32_t t = tail;
+            if(head == t)
+                return false;
+            __dmb(); // read the slot only after seeing the producer's head
+            *item = slots[t & (N - 1)];
+            __dmb(); // copy is done before the slot is handed back
+            tail = t + 1;
+            return true;
+        }
+
+        uint32_t size(void) const { // either side, may be stale by the time it returns
+            return head - tail;
+        }
+        bool empty(void) const { return size() == 0; }
+        static constexpr uint32_t capacity(void) { return N; }
+};
+
+#endif
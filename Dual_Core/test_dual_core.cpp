@@ -0,0 +1,237 @@
+/*
+ * Tests for the dual-core framework: the tick schedule, overrun and load accounting, commands,
+ *  flash writes while core 1 ticks and switch debouncing on the simulated board, and the SPSC
+ *  queue on two real host threads.
+ */
+#include "sim_test.h"
+#include "sim.h"
+#include "dual_core.h"
+#include "rt_switches.h"
+#include "spsc_queue.h"
+#include "flash_log.h"
+#include <pico/stdlib.h>
+#include <pico/multicore.h>
+#include <thread>
+
+#define TICK_US 1000
+
+/*
+ * Run n ticks as core 1 would: wait for the tick, then run it
+ */
+static void run_ticks(RT_Core* rt, int n){
+    sim_set_core(1);
+    for(int i = 0; i < n; i++){
+        busy_wait_until(rt->get_next_tick_us());
+        rt->run_tick();
+    }
+    sim_set_core(0);
+}
+
+static void count_call(void* ctx){
+    (*(int*)ctx)++;
+}
+
+static void busy_250us(void* ctx){
+    (void)ctx;
+    busy_wait_us(250);
+}
+
+static void test_spsc_queue(){
+    SPSC_Queue<int, 4> q;
+    int v = 0;
+    CHECK(q.empty());
+    CHECK(!q.pop(&v));
+    for(int i = 0; i < 4; i++)
+        CHECK(q.push(i));
+    CHECK(!q.push(4));  // full
+    CHECK_EQ(q.size(), 4);
+    for(int i = 0; i < 4; i++){
+        CHECK(q.pop(&v));
+        CHECK_EQ(v, i);
+    }
+
+    // producer and consumer on two threads, every item arrives once and in order
+    SPSC_Queue<uint32_t, 16> shared;
+    const uint32_t items = 1000000;
+    std::thread producer([&](){
+        for(uint32_t i = 0; i < items; i++){
+            while(!shared.push(i))
+                std::this_thread::yield();
+        }
+    });
+    uint32_t expected = 0;
+    bool in_order = true;
+    while(expected < items){
+        uint32_t got;
+        if(!shared.pop(&got)){
+            std::this_thread::yield();
+            continue;
+        }
+        in_order = in_order && got == expected;
+        expected++;
+    }
+    producer.join();
+    CHECK(in_order);
+    CHECK(shared.empty());
+}
+
+static void test_task_periods(){
+    sim_reset();
+    RT_Core rt(TICK_US);
+    int every_tick = 0, every_4th = 0;
+    CHECK(rt.add_task(count_call, &every_tick));
+    CHECK(rt.add_task(count_call, &every_4th, 4));
+    rt.start();
+    CHECK(sim_core1_launched());
+
+    run_ticks(&rt, 100);
+    CHECK_EQ(every_tick, 100);
+    CHECK_EQ(every_4th, 25);
+    CHECK_EQ(rt.stats().ticks, 100);
+    CHECK_EQ(rt.stats().overruns, 0);
+    CHECK_EQ(time_us_64(), 99 * TICK_US); // ticks started exactly on the grid
+}
+
+static void test_load_and_overrun(){
+    sim_reset();
+    RT_Core rt(TICK_US);
+    rt.add_task(busy_250us, NULL);
+    run_ticks(&rt, 200);
+
+    RT_Stats s = rt.stats();
+    CHECK(s.load_permille >= 245 && s.load_permille <= 255);
+    CHECK_EQ(s.max_busy_us, 250);
+    CHECK_EQ(s.overruns, 0);
+
+    // one slow tick: 2.5 ticks of work, two ticks skipped, back on the grid afterwards
+    rt.reset_stats();
+    run_ticks(&rt, 1);
+    sim_set_core(1);
+    busy_wait_us(2500);
+    rt.run_tick();
+    sim_set_core(0);
+    CHECK_EQ(rt.get_next_tick_us() % TICK_US, 0);
+    CHECK(rt.get_next_tick_us() > time_us_64());
+    run_ticks(&rt, 5);
+
+    s = rt.stats();
+    CHECK_EQ(s.ticks, 7);
+    CHECK_EQ(s.overruns, 1);
+}
+
+struct Received {
+    int count;
+    uint8_t command[8];
+    int32_t arg[8];
+};
+
+static void on_command(uint8_t command, int32_t arg, void* ctx){
+    Received* r = (Received*)ctx;
+    if(r->count < 8){
+        r->command[r->count] = command;
+        r->arg[r->count] = arg;
+    }
+    r->count++;
+}
+
+static void test_commands(){
+    sim_reset();
+    Received r = {};
+    RT_Core rt(TICK_US);
+    rt.set_command_handler(on_command, &r);
+    rt.start();
+
+    CHECK(rt_send_command(1, -2048));       // ex. move the stepper 2048 steps CW
+    CHECK(rt.send_command(2, 0x7FFFFF));
+    for(int i = 0; i < 6; i++)
+        CHECK(rt_send_command(3, i));
+    CHECK(!rt_send_command(4, 0));          // the queue holds RT_COMMAND_QUEUE_SIZE, core 0 doesn't block
+    CHECK_EQ(sim_fifo_level(0), 0);         // the SIO FIFO is left to the lockout handler
+
+    run_ticks(&rt, 1);
+    CHECK_EQ(r.count, 8);
+    CHECK_EQ(r.command[0], 1);
+    CHECK_EQ(r.arg[0], -2048);
+    CHECK_EQ(r.arg[1], 0x7FFFFF);
+    CHECK_EQ(r.arg[7], 5);
+    CHECK_EQ(rt.stats().commands, 8);
+}
+
+static void log_sample(Flash_Log* log){
+    multicore_lockout_start_blocking();     // core 1 waits in the lockout handler (RAM) meanwhile
+    log->append(time_us_32(), 0x6540, 0x8000);
+    multicore_lockout_end_blocking();
+}
+
+/*
+ * Core 1 ticks from flash while core 0 logs to flash: every erase and program happens with
+ *  core 1 locked out, and commands still get through
+ */
+static void test_flash_log_while_ticking(){
+    sim_reset();
+    sim_flash_erase_chip();
+    Received r = {};
+    int ticks = 0;
+    RT_Core rt(TICK_US);
+    rt.add_task(count_call, &ticks);
+    rt.set_command_handler(on_command, &r);
+    rt.start();
+    sim_set_core(1);
+    rt.begin_core1();                       // what core1_entry() does before the first tick
+    sim_set_core(0);
+    CHECK(multicore_lockout_victim_is_initialized(1));
+
+    Flash_Log log(FLASH_LOG_OFFSET, 4);
+    log.begin();
+    for(int i = 0; i < 1500; i++){
+        log_sample(&log);
+        CHECK(rt.send_command(1, i));
+        run_ticks(&rt, 1);
+    }
+    multicore_lockout_start_blocking();
+    log.flush();
+    multicore_lockout_end_blocking();
+
+    CHECK(log.get_blocks_written() >= 2);
+    CHECK_EQ(sim_flash_unsafe_writes(), 0);
+    CHECK_EQ(ticks, 1500);
+    CHECK_EQ(r.count, 1500);
+
+    // the same write without the lockout would crash core 1 on the board
+    log.append(time_us_32(), 0, 0);
+    log.flush();
+    CHECK(sim_flash_unsafe_writes() > 0);
+}
+
+static void test_switch_debounce(){
+    sim_reset();
+    const uint32_t SW = 1u << 19;
+    RT_Switches switches(SW, 3);
+    CHECK_EQ(switches.scan(), 0);           // pulled up, released
+
+    // bounce: low, high, low, then stays low
+    sim_gpio_set_input(19, false);
+    CHECK_EQ(switches.scan(), 0);
+    sim_gpio_set_input(19, true);
+    CHECK_EQ(switches.scan(), 0);
+    sim_gpio_set_input(19, false);
+    uint32_t changed = 0;
+    int scans = 0;
+    while(changed == 0 && scans < 10){
+        changed = switches.scan();
+        scans++;
+    }
+    CHECK_EQ(changed, SW);
+    CHECK_EQ(scans, 4);                     // first low reading plus 3 stable scans
+    CHECK_EQ(switches.pressed(), SW);
+}
+
+int main(){
+    RUN_TEST(test_spsc_queue);
+    RUN_TEST(test_task_periods);
+    RUN_TEST(test_load_and_overrun);
+    RUN_TEST(test_commands);
+    RUN_TEST(test_flash_log_while_ticking);
+    RUN_TEST(test_switch_debounce);
+    return TEST_RESULT();
+}
@@ -0,0 +1,119 @@
+/*
+ * Compressed sample log in a reserved region at the end of flash
+ */
+#include "flash_log.h"
+#include <hardware/sync.h>
+
+Flash_Log::Flash_Log(uint32_t region_offset, uint32_t sector_count) : buffer(), encoder(buffer){
+    this->region_offset = region_offset;
+    this->sector_count = sector_count;
+    next_sector = 0;
+    next_sequence = 1;
+    blocks_written = 0;
+}
+
+const uint8_t* Flash_Log::sector_ptr(uint32_t sector) const {
+    return (const uint8_t*)(XIP_BASE + region_offset + sector * FLASH_SECTOR_SIZE);
+}
+
+/*
+ * Scan the region for the newest valid block and continue in the sector after it
+ */
+void Flash_Log::begin(void){
+    bool found = false;
+    uint32_t newest = 0;
+
+    for(uint32_t s = 0; s < sector_count; s++){
+        uint32_t seq;
+        if(log_block_decode(sector_ptr(s), &seq, NULL, NULL) < 0)
+            continue;
+        if(!found || (int32_t)(seq - newest) > 0){
+            found = true;
+            newest = seq;
+            next_sector = (s + 1) % sector_count;
+        }
+    }
+    next_sequence = found ? newest + 1 : 1;
+    if(!found)
+        next_sector = 0;
+    blocks_written = 0;
+    encoder.clear();
+}
+
+/*
+ * Erase and program one sector. Interrupts are off meanwhile since flash (XIP) is unavailable while
+ *  it is being written. If core 1 runs code from flash it has to be paused with multicore_lockout.
+ */
+void Flash_Log::write_block(void){
+    encoder.finish(next_sequence);
+
+    uint32_t offset = region_offset + next_sector * FLASH_SECTOR_SIZE;
+    uint32_t irq = save_and_disable_interrupts();
+    flash_range_erase(offset, FLASH_SECTOR_SIZE);
+    // pages past the used bytes are still 0xFF in the buffer, programming them is skipped
+    uint32_t program_len = (encoder.get_used() + FLASH_PAGE_SIZE - 1) & ~(FLASH_PAGE_SIZE - 1);
+    flash_range_program(offset, buffer, program_len);
+    restore_interrupts(irq);
+
+    next_sector = (next_sector + 1) % sector_count;
+    next_sequence++;
+    blocks_written++;
+    encoder.clear();
+}
+
+void Flash_Log::append(const Log_Sample& sample){
+    if(!encoder.add(sample)){
+        write_block();
+        encoder.add(sample);
+    }
+}
+
+void Flash_Log::append(uint32_t time, uint16_t temp_raw, uint16_t hum_raw){
+    Log_Sample s;
+    s.time = time;
+    s.temp_raw = temp_raw;
+    s.hum_raw = hum_raw;
+    append(s);
+}
+
+void Flash_Log::flush(void){
+    if(encoder.get_count() > 0)
+        write_block();
+}
+
+/*
+ * Walk the ring starting at the oldest sector, the one that will be overwritten next
+ */
+uint32_t Flash_Log::read(log_sample_fn fn, void* ctx) const {
+    uint32_t total = 0;
+    for(uint32_t i = 0; i < sector_count; i++){
+        int n = log_block_decode(sector_ptr((next_sector + i) % sector_count), NULL, fn, ctx);
+        if(n > 0)
+            total += n;
+    }
+    return total;
+}
+
+/*
+ * One sector at a time, so interrupts are only held off for one sector erase (~45ms) and not for
+ *  the whole region
+ */
+void Flash_Log::erase(void){
+    for(uint32_t s = 0; s < sector_count; s++){
+        uint32_t irq = save_and_disable_interrupts();
+        flash_range_erase(region_offset + s * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE);
+        restore_interrupts(irq);
+    }
+    next_sector = 0;
+    next_sequence = 1;
+    blocks_written = 0;
+    encoder.clear();
+}
+
+uint16_t Flash_Log::buffered(void) const {
+    return encoder.get_count();
+}
+
+uint32_t Flash_Log::get_blocks_written(void) const {
+    return blocks_written;
+}
@@ -0,0 +1,56 @@
+/*
+ * Compressed sample log in a reserved region at the end of flash.
+ *  Samples are delta encoded into a 4KB block in RAM (see flash_log_format.h). A block is only
+ *  written when it is full or on flush(), so a sector is erased and programmed once per ~1000
+ *  samples instead of on every reading. Blocks go into the region as a ring, oldest overwritten
+ *  first, so every sector sees the same number of erases (wear leveling). After a reset begin()
+ *  finds the newest valid block by its sequence number; blocks torn by a power loss fail their
+ *  CRC and are skipped.
+ *
+ *  Samples still in RAM are lost on power loss, call flush() before sleeping for a long time or
+ *  before an upload.
+ */
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include "flash_log_format.h"
+#include <hardware/flash.h>
+
+#ifndef FLASH_LOG_SECTORS
+#define FLASH_LOG_SECTORS 64 /*256KB at the end of flash reserved for the log*/
+#endif
+
+#ifndef FLASH_LOG_OFFSET
+#define FLASH_LOG_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_LOG_SECTORS * FLASH_SECTOR_SIZE)
+#endif
+
+static_assert(LOG_BLOCK_SIZE == FLASH_SECTOR_SIZE, "one log block per flash sector");
+
+class Flash_Log {
+    private:
+        uint32_t region_offset;     // flash offset of the first sector of the ring
+        uint32_t sector_count;
+        uint32_t next_sector;       // sector the next block goes to
+        uint32_t next_sequence;
+        uint32_t blocks_written;
+        uint8_t buffer[LOG_BLOCK_SIZE];
+        Log_Block_Encoder encoder;
+
+        const uint8_t* sector_ptr(uint32_t sector) const;   // memory mapped (XIP) view of a sector
+        void write_block(void);
+
+    public:
+        Flash_Log(uint32_t region_offset=FLASH_LOG_OFFSET, uint32_t sector_count=FLASH_LOG_SECTORS);
+
+        void begin(void);                       // find where the log left off, call once after reset
+        void append(const Log_Sample& sample);  // buffer a sample, writes a block when the buffer is full
+        void append(uint32_t time, uint16_t temp_raw, uint16_t hum_raw);
+        void flush(void);                       // write the buffered samples now, even if the block isn't full
+        uint32_t read(log_sample_fn fn, void* ctx) const; // all samples in flash, oldest first, returns count
+        void erase(void);                       // erase the whole region, sector by sector, and drop the buffered samples
+
+        uint16_t buffered(void) const;          // samples waiting in RAM
+        uint32_t get_blocks_written(void) const;    // since begin(), each one cost one sector erase
+};
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * Host tool: decode the sample log from a flash image and print it as CSV.
+ *  usage: flash_log_decode <image> [--offset bytes] [--sectors n]
+ *      image     flash dump starting at flash offset 0 (ex. picotool save -a flash.bin), or the
+ *                file behind the simulator's sim_flash_attach_file()
+ *      --offset  flash offset of the log region, default FLASH_LOG_OFFSET for a 2MB part
+ *      --sectors number of sectors in the region, default FLASH_LOG_SECTORS
+ */
+#include "flash_log_format.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#define DEFAULT_SECTORS 64
+#define DEFAULT_FLASH_SIZE (2 * 1024 * 1024)
+
+struct Block_Ref {
+    uint32_t sequence;
+    uint32_t sector;
+};
+
+static void print_sample(const Log_Sample* s, void* ctx){
+    (void)ctx;
+    // HDC1080 datasheet transfer functions
+    double celsius = s->temp_raw / 65536.0 * 165.0 - 40.0;
+    double rh = s->hum_raw / 65536.0 * 100.0;
+    printf("%u,%u,%u,%.3f,%.3f\n", s->time, s->temp_raw, s->hum_raw, celsius, rh);
+}
+
+int main(int argc, char** argv){
+    const char* path = NULL;
+    long sectors = DEFAULT_SECTORS;
+    long offset = -1;
+
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--offset") == 0 && i + 1 < argc){
+            offset = strtol(argv[++i], NULL, 0);
+        }else if(strcmp(argv[i], "--sectors") == 0 && i + 1 < argc){
+            sectors = strtol(argv[++i], NULL, 0);
+        }else if(path == NULL){
+            path = argv[i];
+        }else{
+            path = NULL;
+            break;
+        }
+    }
+    if(path == NULL || sectors <= 0){
+        fprintf(stderr, "usage: %s <image> [--offset bytes] [--sectors n]\n", argv[0]);
+        return 2;
+    }
+    if(offset < 0)
+        offset = DEFAULT_FLASH_SIZE - sectors * LOG_BLOCK_SIZE;
+
+    FILE* f = fopen(path, "rb");
+    if(f == NULL){
+        fprintf(stderr, "unable to open %s\n", path);
+        return 1;
+    }
+    std::vector<uint8_t> region((size_t)sectors * LOG_BLOCK_SIZE, 0xFF);
+    fseek(f, offset, SEEK_SET);
+    size_t got = fread(region.data(), 1, region.size(), f);
+    fclose(f);
+    if(got == 0){
+        fprintf(stderr, "%s has no data at offset 0x%lX\n", path, offset);
+        return 1;
+    }
+
+    // order blocks by sequence number, the ring position of the oldest isn't known here
+    std::vector<Block_Ref> blocks;
+    int bad = 0;
+    for(long s = 0; s < sectors; s++){
+        Block_Ref ref;
+        ref.sector = (uint32_t)s;
+        const uint8_t* block = &region[(size_t)s * LOG_BLOCK_SIZE];
+        if(log_block_decode(block, &ref.sequence, NULL, NULL) >= 0)
+            blocks.push_back(ref);
+        else if(block[0] != 0xFF || block[1] != 0xFF)
+            bad++; // not erased but not valid either: torn or corrupted
+    }
+    std::sort(blocks.begin(), blocks.end(), [](const Block_Ref& a, const Block_Ref& b){
+        return (int32_t)(a.sequence - b.sequence) < 0;
+    });
+
+    printf("time,temp_raw,hum_raw,celsius,rh\n");
+    for(const Block_Ref& ref : blocks)
+        log_block_decode(&region[(size_t)ref.sector * LOG_BLOCK_SIZE], NULL, print_sample, NULL);
+
+    fflush(stdout); // keep the summary after the samples when both go to a terminal
+    fprintf(stderr, "%zu valid blocks, %d damaged blocks skipped\n", blocks.size(), bad);
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * On-flash format of the sample log, see flash_log_format.h
+ */
+#include "flash_log_format.h"
+#include <string.h>
+
+/*
+ * CRC-32 (IEEE 802.3, reflected) with a 16 entry table: small enough for flash and only run once
+ *  per 4KB block.
+ */
+uint32_t log_crc32(uint32_t crc, const uint8_t* data, size_t len){
+    static const uint32_t TABLE[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    crc = ~crc;
+    for(size_t i = 0; i < len; i++){
+        crc = TABLE[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = TABLE[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+static uint8_t* put_varint(uint8_t* p, uint32_t v){
+    while(v >= 0x80){
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+/*
+ * Returns NULL if the varint runs past end or is longer than 5 bytes
+ */
+static const uint8_t* get_varint(const uint8_t* p, const uint8_t* end, uint32_t* v){
+    uint32_t result = 0;
+    for(int shift = 0; shift < 35; shift += 7){
+        if(p >= end)
+            return NULL;
+        uint8_t b = *p++;
+        result |= (uint32_t)(b & 0x7F) << shift;
+        if(!(b & 0x80)){
+            *v = result;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static uint32_t zigzag(int32_t v){
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t unzigzag(uint32_t v){
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+Log_Block_Encoder::Log_Block_Encoder(uint8_t* block){
+    this->block = block;
+    clear();
+}
+
+void Log_Block_Encoder::clear(void){
+    memset(block, 0xFF, LOG_BLOCK_SIZE); // unused space stays erased, programming it costs nothing
+    count = 0;
+    used = sizeof(Log_Block_Header);
+}
+
+bool Log_Block_Encoder::add(const Log_Sample& sample){
+    if(count == 0){
+        first = sample;
+        last = sample;
+        count = 1;
+        return true;
+    }
+    if(used + LOG_MAX_ENTRY_BYTES > LOG_BLOCK_SIZE || count == UINT16_MAX)
+        return false;
+
+    uint8_t* p = &block[used];
+    p = put_varint(p, sample.time - last.time);
+    p = put_varint(p, zigzag((int32_t)sample.temp_raw - (int32_t)last.temp_raw));
+    p = put_varint(p, zigzag((int32_t)sample.hum_raw - (int32_t)last.hum_raw));
+    used = (uint16_t)(p - block);
+    last = sample;
+    count++;
+    return true;
+}
+
+void Log_Block_Encoder::finish(uint32_t sequence){
+    Log_Block_Header header;
+    header.magic = LOG_BLOCK_MAGIC;
+    header.sequence = sequence;
+    header.count = count;
+    header.payload_len = (uint16_t)(used - sizeof(Log_Block_Header));
+    header.first = first;
+    header.crc = 0;
+    memcpy(block, &header, sizeof(header));
+    header.crc = log_crc32(0, block, used);
+    memcpy(block, &header, sizeof(header));
+}
+
+uint16_t Log_Block_Encoder::get_count(void) const {
+    return count;
+}
+
+uint16_t Log_Block_Encoder::get_used(void) const {
+    return used;
+}
+
+int log_block_decode(const uint8_t* block, uint32_t* sequence, log_sample_fn fn, void* ctx){
+    Log_Block_Header header;
+    memcpy(&header, block, sizeof(header));
+
+    if(header.magic != LOG_BLOCK_MAGIC || header.count == 0)
+        return -1;
+    if(header.payload_len > LOG_BLOCK_SIZE - sizeof(Log_Block_Header))
+        return -1;
+
+    uint32_t stored_crc = header.crc;
+    header.crc = 0;
+    uint32_t crc = log_crc32(0, (const uint8_t*)&header, sizeof(header));
+    crc = log_crc32(crc, block + sizeof(header), header.payload_len); // chained, same as one run over both
+    if(crc != stored_crc)
+        return -1;
+
+    if(sequence != NULL)
+        *sequence = header.sequence;
+
+    Log_Sample s = header.first;
+    if(fn != NULL)
+        fn(&s, ctx);
+
+    const uint8_t* p = block + sizeof(header);
+    const uint8_t* end = p + header.payload_len;
+    for(int i = 1; i < header.count; i++){
+        uint32_t dt, dtemp, dhum;
+        p = get_varint(p, end, &dt);
+        if(p != NULL) p = get_varint(p, end, &dtemp);
+        if(p != NULL) p = get_varint(p, end, &dhum);
+        if(p == NULL)
+            return -1; // CRC matched but the payload is inconsistent, writer bug
+
+        s.time += dt;
+        s.temp_raw = (uint16_t)(s.temp_raw + unzigzag(dtemp));
+        s.hum_raw = (uint16_t)(s.hum_raw + unzigzag(dhum));
+        if(fn != NULL)
+            fn(&s, ctx);
+    }
+    return header.count;
+}
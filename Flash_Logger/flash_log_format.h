@@ -0,0 +1,73 @@
+/*
+ * On-flash format of the sample log, shared by the logger on the board and the host decoder.
+ *  No SDK dependencies so it builds anywhere.
+ *
+ *  The log is a ring of blocks, one block per 4KB flash sector:
+ *      header (24 bytes) | encoded samples | 0xFF padding
+ *  The first sample of a block is stored whole in the header. Every following sample is stored as
+ *  the difference to the one before it: time delta as an unsigned varint, temperature and humidity
+ *  deltas zigzag + varint. Slowly changing readings take 3-4 bytes per sample instead of 12.
+ *  A CRC-32 over header and payload detects blocks torn by a power loss.
+ */
+#ifndef FLASH_LOG_FORMAT_H
+#define FLASH_LOG_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define LOG_BLOCK_SIZE 4096         /*one flash sector*/
+#define LOG_BLOCK_MAGIC 0x4C434448  /*"HDCL" little endian*/
+#define LOG_MAX_ENTRY_BYTES 11      /*5 byte time varint + 2 * 3 byte zigzag varints*/
+
+/*
+ * One logged reading, raw HDC1080 codes and a timestamp in the application's units (ex. seconds)
+ */
+struct Log_Sample {
+    uint32_t time;
+    uint16_t temp_raw;
+    uint16_t hum_raw;
+};
+
+struct Log_Block_Header {
+    uint32_t magic;
+    uint32_t sequence;      // +1 for every block written, the highest is the newest
+    Log_Sample first;       // first sample of the block, stored whole
+    uint16_t count;         // samples in the block, including the first
+    uint16_t payload_len;   // encoded bytes following the header
+    uint32_t crc;           // CRC-32 of the header (with crc = 0) and the payload
+};
+
+static_assert(sizeof(Log_Block_Header) == 24, "header layout is part of the flash format");
+
+typedef void (*log_sample_fn)(const Log_Sample* sample, void* ctx);
+
+uint32_t log_crc32(uint32_t crc, const uint8_t* data, size_t len); // start with crc = 0
+
+/*
+ * Builds one block in a caller supplied LOG_BLOCK_SIZE buffer
+ */
+class Log_Block_Encoder {
+    private:
+        uint8_t* block;
+        Log_Sample first;   // goes in the header
+        Log_Sample last;    // deltas are taken against it
+        uint16_t count;
+        uint16_t used;      // bytes used, header included
+
+    public:
+        Log_Block_Encoder(uint8_t* block);
+
+        void clear(void);                       // start an empty block
+        bool add(const Log_Sample& sample);     // false when the block is full, the sample was not added
+        void finish(uint32_t sequence);         // write the header and CRC, block is then ready to program
+        uint16_t get_count(void) const;
+        uint16_t get_used(void) const;          // bytes used, header included
+};
+
+/*
+ * Check a block and, if it is valid, call fn for each sample in order. Returns the number of samples,
+ *  -1 if the block is erased, torn or corrupted. sequence (may be NULL) receives the block sequence.
+ */
+int log_block_decode(const uint8_t* block, uint32_t* sequence, log_sample_fn fn, void* ctx);
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ * Tests for the flash sample log on the simulated flash.
+ *  usage: test_flash_log <image file>, the image is left behind for the decoder test
+ */
+#include "sim_test.h"
+#include "sim.h"
+#include "flash_log.h"
+#include <vector>
+
+#define TEST_SECTORS 8
+
+static const char* image_path;
+
+static Log_Sample make_sample(uint32_t i){
+    Log_Sample s;
+    s.time = 1000 + i * 5;                                      // every 5 seconds
+    s.temp_raw = (uint16_t)(25000 + (i / 7) % 40 - (i % 3));    // slow drift plus noise
+    s.hum_raw = (uint16_t)(30000 + (i / 11) % 90 + (i % 5));
+    return s;
+}
+
+static void collect(const Log_Sample* s, void* ctx){
+    ((std::vector<Log_Sample>*)ctx)->push_back(*s);
+}
+
+static bool same(const Log_Sample& a, const Log_Sample& b){
+    return a.time == b.time && a.temp_raw == b.temp_raw && a.hum_raw == b.hum_raw;
+}
+
+static void test_block_roundtrip(){
+    uint8_t block[LOG_BLOCK_SIZE];
+    Log_Block_Encoder enc(block);
+    uint32_t n = 0;
+    while(enc.add(make_sample(n)))
+        n++;
+    enc.finish(42);
+
+    std::vector<Log_Sample> out;
+    uint32_t seq = 0;
+    CHECK_EQ(log_block_decode(block, &seq, collect, &out), n);
+    CHECK_EQ(seq, 42);
+    CHECK_EQ(out.size(), n);
+    bool all_same = true;
+    for(uint32_t i = 0; i < out.size(); i++)
+        all_same = all_same && same(out[i], make_sample(i));
+    CHECK(all_same);
+    CHECK(LOG_BLOCK_SIZE / (double)n < 4.0); // vs 12 bytes for a time + two float32
+
+    block[100] ^= 0x01;
+    CHECK_EQ(log_block_decode(block, NULL, NULL, NULL), -1);
+}
+
+static void test_wrap_keeps_newest(){
+    sim_reset();
+    sim_flash_erase_chip();
+    Flash_Log log(FLASH_LOG_OFFSET, 4);
+    log.begin();
+
+    uint32_t n = 0;
+    while(log.get_blocks_written() < 10)
+        log.append(make_sample(n++));
+    log.flush();
+    CHECK_EQ(sim_flash_erases(), 11);   // one erase per block, spread over the ring
+
+    std::vector<Log_Sample> out;
+    log.read(collect, &out);
+    CHECK(!out.empty());
+    bool ordered = true;
+    for(size_t i = 1; i < out.size(); i++)
+        ordered = ordered && out[i].time == out[i - 1].time + 5;
+    CHECK(ordered);
+    CHECK(same(out.back(), make_sample(n - 1)));
+}
+
+static void test_torn_block_skipped(){
+    sim_reset();
+    sim_flash_erase_chip();
+    Flash_Log log(FLASH_LOG_OFFSET, TEST_SECTORS);
+    log.begin();
+
+    for(uint32_t i = 0; i < 100; i++)
+        log.append(make_sample(i));
+    log.flush();
+    for(uint32_t i = 100; i < 200; i++)
+        log.append(make_sample(i));
+    sim_flash_fail_program_after(64);   // power lost while programming
+    log.flush();
+
+    sim_reset();                        // power comes back
+    Flash_Log rebooted(FLASH_LOG_OFFSET, TEST_SECTORS);
+    rebooted.begin();
+    std::vector<Log_Sample> out;
+    CHECK_EQ(rebooted.read(collect, &out), 100);
+
+    for(uint32_t i = 200; i < 250; i++) // the torn sector is reused
+        rebooted.append(make_sample(i));
+    rebooted.flush();
+    out.clear();
+    CHECK_EQ(rebooted.read(collect, &out), 150);
+    CHECK(same(out[100], make_sample(200)));
+}
+
+static void test_survives_reboot_in_file(){
+    sim_reset();
+    CHECK(sim_flash_attach_file(image_path));
+    sim_flash_erase_chip();
+
+    Flash_Log log(FLASH_LOG_OFFSET, TEST_SECTORS);
+    log.begin();
+    for(uint32_t i = 0; i < 3000; i++)
+        log.append(make_sample(i));
+    log.flush();
+    CHECK(sim_flash_erases() <= 4);     // batched: 3000 samples, a handful of sector writes
+
+    // power cycle: reload the flash from the file
+    sim_flash_detach_file();
+    sim_flash_erase_chip();
+    CHECK(sim_flash_attach_file(image_path));
+    sim_reset();
+
+    Flash_Log rebooted(FLASH_LOG_OFFSET, TEST_SECTORS);
+    rebooted.begin();
+    std::vector<Log_Sample> out;
+    CHECK_EQ(rebooted.read(collect, &out), 3000);
+    bool all_same = out.size() == 3000;
+    for(uint32_t i = 0; all_same && i < out.size(); i++)
+        all_same = same(out[i], make_sample(i));
+    CHECK(all_same);
+    sim_flash_detach_file();
+}
+
+static void test_erase(){
+    sim_reset();
+    sim_flash_erase_chip();
+    Flash_Log log(FLASH_LOG_OFFSET, TEST_SECTORS);
+    log.begin();
+    for(uint32_t i = 0; i < 100; i++)
+        log.append(make_sample(i));
+    log.flush();
+    log.append(make_sample(100));
+    CHECK_EQ(log.get_blocks_written(), 1);
+
+    uint64_t erases = sim_flash_erases();
+    log.erase();
+    CHECK_EQ(sim_flash_erases() - erases, TEST_SECTORS);
+    CHECK_EQ(log.get_blocks_written(), 0);
+    CHECK_EQ(log.buffered(), 0);
+    std::vector<Log_Sample> out;
+    CHECK_EQ(log.read(collect, &out), 0);
+
+    // logging starts over in the first sector
+    log.append(make_sample(0));
+    log.flush();
+    Flash_Log rebooted(FLASH_LOG_OFFSET, TEST_SECTORS);
+    rebooted.begin();
+    CHECK_EQ(rebooted.read(collect, &out), 1);
+}
+
+int main(int argc, char** argv){
+    image_path = argc > 1 ? argv[1] : "test_flash.bin";
+    remove(image_path);
+
+    RUN_TEST(test_block_roundtrip);
+    RUN_TEST(test_wrap_keeps_newest);
+    RUN_TEST(test_torn_block_skipped);
+    RUN_TEST(test_survives_reboot_in_file);
+    RUN_TEST(test_erase);
+    return TEST_RESULT();
+}
@@ -6,6 +6,7 @@
  * Date: 02/12/2022
  */
 #include "hdc1080.h"
+#include "driver_instrument.h"
 
 /*
  * Do the default initialization for the HDC1080
@@ -20,6 +21,66 @@ HDC1080::HDC1080(void){
     I2C_PORT = i2c0;
 }
 
+/*
+ * Write bytes to the sensor and count the outcome. Tag is the register the write refers to
+ *  and is only used to label entries in the event log.
+ */
+int HDC1080::write_bytes(const uint8_t* src, size_t len, uint8_t tag){
+    INSTR_SCOPE(INSTR_I2C_TRANSACTION);
+    int result = i2c_write_timeout_us(I2C_PORT, HDC1080_ADDR, src, len, false, HDC_I2C_TIMEOUT_US);
+    if(result==PICO_ERROR_TIMEOUT){
+        diag.record(DIAG_TIMEOUT, tag, result);
+    }else if(result < 0){
+        diag.record(DIAG_NACK, tag, result);
+    }
+    return result;
+}
+
+/*
+ * Read bytes from the sensor and count the outcome. The HDC1080 NACKs reads while a conversion is
+ *  still running and the datasheet conversion times are typical, not maximum, so a read that came
+ *  slightly early is repeated up to HDC_I2C_READ_RETRIES times, HDC_I2C_RETRY_DELAY_US apart.
+ */
+int HDC1080::read_bytes(uint8_t* dst, size_t len, uint8_t tag){
+    INSTR_SCOPE(INSTR_I2C_TRANSACTION);
+    int result = PICO_ERROR_GENERIC;
+    for(int attempt = 0; attempt <= HDC_I2C_READ_RETRIES; attempt++){
+        if(attempt > 0){
+            diag.record(DIAG_RETRY, tag, result);
+            sleep_us(HDC_I2C_RETRY_DELAY_US); // give the conversion time to finish
+        }
+
+        result = i2c_read_timeout_us(I2C_PORT, HDC1080_ADDR, dst, len, false, HDC_I2C_TIMEOUT_US);
+        if(result==PICO_ERROR_TIMEOUT){
+            diag.record(DIAG_TIMEOUT, tag, result);
+            return result; // bus is stuck, retrying won't help
+        }else if(result >= 0){
+            return result;
+        }
+        diag.record(DIAG_NACK, tag, result);
+    }
+    return result;
+}
+
+/*
+ * Block while the sensor converts, kept in one place so the wait shows up in the instrumentation
+ */
+void HDC1080::wait_conversion(uint32_t ms){
+    INSTR_SCOPE(INSTR_CONVERSION_WAIT);
+    sleep_ms(ms);
+}
+
+/*
+ * Counters and event log for this sensor, dump them from the application when needed
+ */
+const Driver_Diag& HDC1080::diagnostics(void) const {
+    return diag;
+}
+
+void HDC1080::reset_diagnostics(void){
+    diag.reset();
+}
+
 /*
  * Write a 16 bit config value to the config register. This must be done before taking a measurement.
  *  Also use this for reading battery voltage warnings and turning on the heater.
@@ -28,29 +89,25 @@ void HDC1080::set_config(HDC_Config c_value){
     const uint8_t CONFIG_REG=0x02;
     uint8_t data[] = {CONFIG_REG, c_value, 0x00}; // write three bytes, last should always be 0x00
     // pointer write to 0x02 with the config values following
-    int result = i2c_write_blocking(I2C_PORT, HDC1080_ADDR, &data[0], 3, false);
-    if(result==PICO_ERROR_GENERIC){ // check if valid
-        printf("[ERROR] WRITE POINTER I2C unable to write bytes to HDC1080 config, address not acknowledged or no device\n");
+    int result = write_bytes(&data[0], 3, CONFIG_REG);
+    if(result < 0) // check if valid
         return;
-    }
+
+    diag.increment(DIAG_CONFIG_WRITE);
 }
 
 uint8_t HDC1080::read_config(){
     const uint8_t CONFIG_REG=0x02;
 
     // set pointer for read
-    int result = i2c_write_blocking(I2C_PORT, HDC1080_ADDR, &CONFIG_REG, 1, false);
-    if(result==PICO_ERROR_GENERIC){ // check if valid
-        printf("[ERROR] WRITE POINTER I2C unable to write bytes to HDC1080 config, address not acknowledged or no device\n");
+    int result = write_bytes(&CONFIG_REG, 1, CONFIG_REG);
+    if(result < 0) // check if valid
         return 0x00;
-    }
 
     uint8_t output[2];
-    result = i2c_read_blocking(I2C_PORT, HDC1080_ADDR, output, 2, false);
-    if(result==PICO_ERROR_GENERIC){ // check if valid
-        printf("[ERROR] WRITE POINTER I2C unable to write bytes to HDC1080 config, address not acknowledged or no device\n");
+    result = read_bytes(output, 2, CONFIG_REG);
+    if(result < 0) // check if valid
         return 0x00;
-    }
 
     return output[0];
 }
@@ -63,8 +120,9 @@ uint8_t HDC1080::read_config(){
  *      dst[2] = temperature in Fahrenheit, only if size is 3, otherwise just the first two
  */
 void HDC1080::read_both(Degrees degrees, HDC_Resolution res, float* dst, int size){
+    INSTR_SCOPE(INSTR_HDC_READ_BOTH);
     if(dst == NULL){ // check for invalid inputs
-        printf("[ERROR] NULL destination ptr(dst) passed to read_both()\n");
+        diag.record(DIAG_BAD_ARG, HDC_TEMP, PICO_ERROR_INVALID_ARG);
         return;
     }
 
@@ -77,22 +135,23 @@ void HDC1080::read_both(Degrees degrees, HDC_Resolution res, float* dst, int siz
 
     // trigger measurement
     const uint8_t TEMP_REG=0x00;
-    int result = i2c_write_blocking(I2C_PORT, HDC1080_ADDR, &TEMP_REG, 1, false);
-    if(result==PICO_ERROR_GENERIC)
-        printf("[ERROR] WRITE POINTER I2C unable to write, address not acknowledged or available\n");
+    int result = write_bytes(&TEMP_REG, 1, TEMP_REG);
+    if(result < 0)
+        return;
 
     // wait for the measurement to complete
     if(res==HIGH_RES){
-        sleep_ms(14);
+        wait_conversion(14);
     }else{
-        sleep_ms(8);
+        wait_conversion(8);
     }
 
     // read the values from the sensor in one read operation
     uint8_t output[4];
-    result = i2c_read_blocking(I2C_PORT, HDC1080_ADDR, &output[0], 4, false);
-    if(result==PICO_ERROR_GENERIC)
-        printf("[ERROR] READ I2C unable to write, address not acknowledged or available\n");
+    result = read_bytes(&output[0], 4, TEMP_REG);
+    if(result < 0)
+        return;
+    diag.increment(DIAG_SAMPLE);
 
     //printf("TEMP: Output[0]=0x%X, Output[1]=0x%X\n", output[0], output[1]);
     //printf("HUM: Output[2]=0x%X, Output[3]=0x%X\n", output[2], output[3]);
@@ -123,6 +182,7 @@ void HDC1080::read_both(Degrees degrees, HDC_Resolution res, float* dst, int siz
  *  Returns the relative humidity as a percentage ex. 40%
  */
 float HDC1080::humidity(HDC_Resolution res){
+    INSTR_SCOPE(INSTR_HDC_READ);
     const uint8_t HUM_REG=0x01; // temperature register pointer
     uint8_t output[2];
 
@@ -136,26 +196,26 @@ float HDC1080::humidity(HDC_Resolution res){
     }
 
     // trigger measurement
-    int result = i2c_write_blocking(I2C_PORT, HDC1080_ADDR, &HUM_REG, 1, false);
-    if(result==PICO_ERROR_GENERIC)
-        printf("[ERROR] Writing Humidity: I2C address not acknowledged or no device present\n");
+    int result = write_bytes(&HUM_REG, 1, HUM_REG);
+    if(result < 0)
+        return 0;
 
     // wait for measurement to complete, 7ms (14bit), 4ms (11bit)
     if(res==HIGH_RES)
-        sleep_ms(7);
+        wait_conversion(7);
     else if(res==MEDIUM_RES){
-        sleep_ms(4);
+        wait_conversion(4);
     }else{
-        sleep_ms(3);
+        wait_conversion(3);
     }
 
     // read the humidity register, returns 16 bits, first two are always 0
-    result = i2c_read_blocking(I2C_PORT, HDC1080_ADDR, output, 2, false);
+    result = read_bytes(output, 2, HUM_REG);
 
-    if(result==PICO_ERROR_GENERIC){
-        printf("[ERROR] Reading Humidity: I2C address not acknowledged or no device present\n");
+    if(result < 0){
         return 0;
     }else{
+        diag.increment(DIAG_SAMPLE);
         //printf("\t\tOutput[0]:0x%X\n\t\tOutput[1]:0x%X\n", output[0], output[1]);
         int16_t raw_bit_hum = output[0]<<8|output[1];
         double mid_rep = ((double)raw_bit_hum)/((double)65536);
@@ -207,9 +267,7 @@ void HDC1080::trigger_temp_measurement(HDC_Resolution res){
     }
 
     // trigger measurement
-    int result = i2c_write_blocking(I2C_PORT, HDC1080_ADDR, &TEMP_REG, 1, false);
-    if(result==PICO_ERROR_GENERIC)
-        printf("[ERROR] Writing Temp: I2C address not acknowledged or no device present\n");
+    write_bytes(&TEMP_REG, 1, TEMP_REG);
 }
 
 /*
@@ -229,9 +287,7 @@ void HDC1080::trigger_humidity_measurement(HDC_Resolution res){
     }
 
     // trigger measurement
-    int result = i2c_write_blocking(I2C_PORT, HDC1080_ADDR, &HUM_REG, 1, false);
-    if(result==PICO_ERROR_GENERIC)
-        printf("[ERROR] Writing Humidity: I2C address not acknowledged or no device present\n");
+    write_bytes(&HUM_REG, 1, HUM_REG);
 }
 
 /*
@@ -246,9 +302,7 @@ void HDC1080::trigger_both(HDC_Resolution res){
 
     // trigger measurement
     const uint8_t TEMP_REG=0x00;
-    int result = i2c_write_blocking(I2C_PORT, HDC1080_ADDR, &TEMP_REG, 1, false);
-    if(result==PICO_ERROR_GENERIC)
-        printf("[ERROR] WRITE POINTER I2C unable to write, address not acknowledged or available\n");
+    write_bytes(&TEMP_REG, 1, TEMP_REG);
 }
 
 /*
@@ -258,11 +312,10 @@ uint16_t HDC1080::read_raw(){
     uint8_t output[2];
     //printf("--- READ RAW ---\n");
     // read the humidity register, returns 16 bits, first two are always 0
-    int result = i2c_read_blocking(I2C_PORT, HDC1080_ADDR, output, 2, false);
-    if(result==PICO_ERROR_GENERIC){
-        printf("[ERROR] Reading Raw: I2C address not acknowledged or no device present\n");
+    int result = read_bytes(output, 2, HDC_TEMP);
+    if(result < 0)
         return 0;
-    }
+    diag.increment(DIAG_SAMPLE);
 
     //printf("\t\tOutput[0]:0x%X\n\t\tOutput[1]:0x%X\n", output[0], output[1]);
     return output[0]<<8|output[1];
@@ -270,13 +323,17 @@ uint16_t HDC1080::read_raw(){
 
 /*
  * Read both the temperature and humidity after setting the sensor in combo read mode.
- *  Must wait 14ms after triggering measurement to read these.
+ *  Must wait 14ms after triggering measurement to read these. Returns 0, or the bus error.
  */
-void HDC1080::read_both_raw(uint16_t* temp, uint16_t* humidity){
+int HDC1080::read_both_raw(uint16_t* temp, uint16_t* humidity){
     uint8_t output[4];
-    int result = i2c_read_blocking(I2C_PORT, HDC1080_ADDR, &output[0], 4, false);
-    if(result==PICO_ERROR_GENERIC)
-        printf("[ERROR] READ BOTH I2C address not acknowledged or available\n");
+    int result = read_bytes(&output[0], 4, HDC_TEMP);
+    if(result < 0){
+        *temp = 0;
+        *humidity = 0;
+        return result;
+    }
+    diag.increment(DIAG_SAMPLE);
 
     //printf("TEMP: Output[0]=0x%X, Output[1]=0x%X\n", output[0], output[1]);
     //printf("HUM: Output[2]=0x%X, Output[3]=0x%X\n", output[2], output[3]);
@@ -286,6 +343,7 @@ void HDC1080::read_both_raw(uint16_t* temp, uint16_t* humidity){
 
     // convert humidity value to float
     *humidity = output[2]<<8|output[3];
+    return 0;
 }
 
 /*
@@ -307,14 +365,14 @@ float HDC1080::raw_to_float(uint16_t raw, HDC_Measure des_output){
  */
 uint16_t HDC1080::read_manufacturer_id(){
     // set pointer value to manufacturer id register
-    int result = i2c_write_blocking(I2C_PORT, HDC1080_ADDR, &MAN_ID, 1, false);
-    if(result==PICO_ERROR_GENERIC)
-        printf("[ERROR] I2C unable to write bytes to HDC1080, address not acknowledged or no device\n");
+    int result = write_bytes(&MAN_ID, 1, MAN_ID);
+    if(result < 0)
+        return 0;
 
     uint8_t output[2];
-    result = i2c_read_blocking(I2C_PORT, HDC1080_ADDR, output, 2, false);
-    if(result==PICO_ERROR_GENERIC)
-        printf("[ERROR] I2C address not acknowledged or no device present\n");
+    result = read_bytes(output, 2, MAN_ID);
+    if(result < 0)
+        return 0;
 
     int man_id = output[0]<<8|output[1];
 
@@ -330,18 +388,14 @@ uint64_t HDC1080::read_UID(){
     uint16_t accum[3]; // three 16 bit register values read from device
 
     for(int i = 0; i < 3; i++){
-        int result = i2c_write_blocking(I2C_PORT, HDC1080_ADDR, &target_reg, 1, false);
-        if(result==PICO_ERROR_GENERIC){ // check if valid
-            printf("[ERROR] I2C unable to write bytes to HDC1080, address not acknowledged or no device\n");
+        int result = write_bytes(&target_reg, 1, target_reg);
+        if(result < 0) // check if valid
             return PICO_ERROR_GENERIC;
-        }
 
         uint8_t output[2];
-        result = i2c_read_blocking(I2C_PORT, HDC1080_ADDR, output, 2, false);
-        if(result==PICO_ERROR_GENERIC){ // check if valid
-            printf("[ERROR] I2C address not acknowledged or no device present\n");
+        result = read_bytes(output, 2, target_reg);
+        if(result < 0) // check if valid
             return PICO_ERROR_GENERIC;
-        }
 
         //printf("Output[%d]: [0]=0x%X, [1]=0x%X\n", i, output[0], output[1]);
         accum[i] = output[0]<<8|output[1];
@@ -370,6 +424,7 @@ void HDC1080::set_heater(bool heater_on){
  *  Resolution can be HIGH, MEDIUM, or LOW
  */
 float HDC1080::temperature(Degrees deg, HDC_Resolution res){
+    INSTR_SCOPE(INSTR_HDC_READ);
     const uint8_t TEMP_REG=0x00; // temperature register pointer
     uint8_t output[2];
 
@@ -381,24 +436,24 @@ float HDC1080::temperature(Degrees deg, HDC_Resolution res){
     }
 
     // trigger measurement
-    int result = i2c_write_blocking(I2C_PORT, HDC1080_ADDR, &TEMP_REG, 1, false);
-    if(result==PICO_ERROR_GENERIC)
-        printf("[ERROR] Writing Temp: I2C address not acknowledged or no device present\n");
+    int result = write_bytes(&TEMP_REG, 1, TEMP_REG);
+    if(result < 0)
+        return 0;
 
     // wait for measurement to complete, 7ms (14bit), 4ms (11bit)
     if(res==HIGH_RES)
-        sleep_ms(7);
+        wait_conversion(7);
     else if(res==MEDIUM_RES){
-        sleep_ms(4);
+        wait_conversion(4);
     }
 
     // read the temperature register
-    result = i2c_read_blocking(I2C_PORT, HDC1080_ADDR, output, 2, false);
+    result = read_bytes(output, 2, TEMP_REG);
 
-    if(result==PICO_ERROR_GENERIC){
-        printf("[ERROR] Reading Temp: I2C address not acknowledged or no device present\n");
+    if(result < 0){
         return 0;
     }else{
+        diag.increment(DIAG_SAMPLE);
         //printf("\t\tOutput[0]:0x%X\n\t\tOutput[1]:0x%X\n", output[0], output[1]);
         // convert raw bits to float
         int16_t raw_bit_temp = output[0]<<8|output[1];
@@ -8,14 +8,24 @@
 #ifndef HDC1080_H
 #define HDC1080_H
 
-#include <string>
 #include <hardware/i2c.h>
-
-using namespace std;
+#include "driver_diag.h"
 
 enum Degrees {CELSIUS=0, FAHRENHEIT=1};
 enum HDC_Measure {TEMPERATURE_C, TEMPERATURE_F, HUMIDITY};
 enum HDC_Resolution {HIGH_RES=14, MEDIUM_RES=11, LOW_RES=8};
+#ifndef HDC_I2C_TIMEOUT_US
+#define HDC_I2C_TIMEOUT_US 5000 /*give up on a single bus transaction after this long*/
+#endif
+
+#ifndef HDC_I2C_READ_RETRIES
+#define HDC_I2C_READ_RETRIES 1  /*extra attempts for a read the sensor did not acknowledge*/
+#endif
+
+#ifndef HDC_I2C_RETRY_DELAY_US
+#define HDC_I2C_RETRY_DELAY_US 1000 /*wait before repeating a NACKed read, longer than a late conversion overruns*/
+#endif
+
 enum HDC_Config {SINGLE_14=0x00,    /*read temp/humidity at 14 bits*/
             TEMP_11=0x04,           /*config to read 11 bit temperature*/
             HUM_11=0x01,            /*read 11 bit humidity*/
@@ -31,8 +41,8 @@ enum HDC_Config {SINGLE_14=0x00,    /*read temp/humidity at 14 bits*/
  */
 class HDC1080 {
     private:
-        // register pointers
-        const uint8_t HDC1080_ADDR=0x40, /*default address for the HDC1080*/
+        // register pointers, static so they cost no RAM per sensor
+        static constexpr uint8_t HDC1080_ADDR=0x40, /*default address for the HDC1080*/
             HDC_TEMP=0x00,      /*temperature register*/
             HDC_HUM=0x01,       /*humidity register*/
             HDC_CONFIG=0x02,    /*configuration register*/
@@ -43,7 +53,12 @@ class HDC1080 {
             DEV_ID=0xFF;        /*device ID*/
 
         i2c_inst_t* I2C_PORT=i2c0;
+        Driver_Diag diag;       // error/event counters, replaces printing errors to stdio
+
         float temperature(Degrees, HDC_Resolution);
+        int write_bytes(const uint8_t*, size_t, uint8_t);   // counted I2C write, last arg tags the log entry
+        int read_bytes(uint8_t*, size_t, uint8_t);          // counted I2C read with retry on NACK
+        void wait_conversion(uint32_t);                     // block for the sensor conversion time in ms
 
     public:
         HDC1080(i2c_inst_t* i2c_port);
@@ -66,13 +81,16 @@ class HDC1080 {
         void trigger_both(HDC_Resolution);
 
         uint16_t read_raw();                            // get the raw 16 bit output of the temperature or humidity sensor
-        void read_both_raw(uint16_t*, uint16_t*);
+        int read_both_raw(uint16_t*, uint16_t*);        // 0, or PICO_ERROR_* with both outputs set to 0 if the read failed
 
         uint16_t read_manufacturer_id(void);            // read the TI manufacturer ID, should be 0x5449
         uint64_t read_UID(void);                        // read the 40 bit unique ID, aka serial number
 
         float raw_to_float(uint16_t, HDC_Measure);  // convert a 16 bit raw sensor output to humidity or temperature in float form
 
+        const Driver_Diag& diagnostics(void) const;     // counters and event log for this sensor
+        void reset_diagnostics(void);                   // clear counters and event log
+
 };
 
 #endif
@@ -0,0 +1,42 @@
+/*
+ * Duty-cycled, low power sampling for the HDC1080
+ */
+#include "hdc1080_low_power.h"
+#include <hardware/timer.h>
+
+/*
+ * The first sample() measures right away
+ */
+HDC1080_Low_Power::HDC1080_Low_Power(HDC1080* sensor, HDC_Resolution res, uint32_t period_ms){
+    this->sensor = sensor;
+    this->res = res;
+    period_us = period_ms * 1000;
+    next_sample_us = 0;
+}
+
+uint32_t HDC1080_Low_Power::conversion_time_us(HDC_Resolution res){
+    return res == HIGH_RES ? HDC_BOTH_CONVERSION_US_14 : HDC_BOTH_CONVERSION_US_11;
+}
+
+void HDC1080_Low_Power::restart(void){
+    next_sample_us = 0;
+}
+
+/*
+ * Take one sample per period:
+ *      sleep until the period starts -> trigger both measurements -> sleep for the conversion -> read
+ *  Results are raw codes, convert them with HDC1080::raw_to_float() or filter them first.
+ *  If the caller was busy for longer than a period, the missed periods are skipped, not caught up.
+ */
+bool HDC1080_Low_Power::sample(uint16_t* temp_raw, uint16_t* hum_raw){
+    uint64_t now = time_us_64();
+    if(next_sample_us > now)
+        sleeper.sleep_until_us(next_sample_us, true);
+    else
+        next_sample_us = now;
+    next_sample_us += period_us;
+
+    sensor->trigger_both(res);
+    sleeper.sleep_until_us(time_us_64() + conversion_time_us(res), true);
+    return sensor->read_both_raw(temp_raw, hum_raw) == 0;
+}
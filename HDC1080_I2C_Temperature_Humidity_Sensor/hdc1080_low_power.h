@@ -0,0 +1,34 @@
+/*
+ * Duty-cycled, low power sampling for the HDC1080.
+ *  Instead of blocking in sleep_ms() with the core running at full clock, the sampler arms a timer
+ *  alarm and sleeps the core (WFI, with all clocks except the timer gated) until the next sample is
+ *  due, triggers the conversion, sleeps again for the conversion time and reads the raw result.
+ */
+#ifndef HDC1080_LOW_POWER_H
+#define HDC1080_LOW_POWER_H
+
+#include "hdc1080.h"
+#include "alarm_sleep.h"
+
+// time to wait after trigger_both() before the result can be read, same as the blocking API
+#define HDC_BOTH_CONVERSION_US_14 14000
+#define HDC_BOTH_CONVERSION_US_11 8000
+
+class HDC1080_Low_Power {
+    private:
+        HDC1080* sensor;
+        HDC_Resolution res;
+        uint32_t period_us;     // time between the start of two samples
+        uint64_t next_sample_us;
+        Alarm_Sleep sleeper;    // wakes the core, all clocks but the timer's gated meanwhile
+
+    public:
+        HDC1080_Low_Power(HDC1080* sensor, HDC_Resolution res, uint32_t period_ms);
+
+        bool sample(uint16_t* temp_raw, uint16_t* hum_raw); // sleep until the next period, measure, return false on bus error
+        void restart(void);                                 // next sample() measures right away
+
+        static uint32_t conversion_time_us(HDC_Resolution); // wait between trigger_both() and read_both_raw()
+};
+
+#endif
@@ -0,0 +1,130 @@
+/*
+ * Tests for the HDC1080 driver's error handling on the simulated bus: NACK, retry and timeout
+ *  counting and the event log entries they leave. Also the low power sampler's timing.
+ */
+#include "sim_test.h"
+#include "sim.h"
+#include "sim_hdc1080.h"
+#include "hdc1080.h"
+#include "hdc1080_low_power.h"
+
+/*
+ * A device that holds the bus until the transfer times out
+ */
+class Stuck_Device : public Sim_I2C_Device {
+    public:
+        int write(const uint8_t* src, size_t len){ (void)src; (void)len; return PICO_ERROR_TIMEOUT; }
+        int read(uint8_t* dst, size_t len){ (void)dst; (void)len; return PICO_ERROR_TIMEOUT; }
+};
+
+/*
+ * Reading right after the trigger: the conversion is still running, the model NACKs, the driver
+ *  waits HDC_I2C_RETRY_DELAY_US and tries again, still too early for a 14 bit conversion
+ */
+static void test_nack_and_retry(){
+    sim_reset();
+    Sim_HDC1080 model;
+    sim_i2c_attach(i2c0, Sim_HDC1080::ADDRESS, &model);
+    HDC1080 hdc(i2c0);
+
+    hdc.trigger_temp_measurement(HIGH_RES);
+    uint64_t start = time_us_64();
+    CHECK_EQ(hdc.read_raw(), 0);
+    CHECK(time_us_64() - start >= HDC_I2C_RETRY_DELAY_US);
+
+    Diag_Counters c = hdc.diagnostics().counters();
+    CHECK_EQ(c.nacks, HDC_I2C_READ_RETRIES + 1);
+    CHECK_EQ(c.retries, HDC_I2C_READ_RETRIES);
+    CHECK_EQ(c.timeouts, 0);
+    CHECK_EQ(c.samples, 0);
+    CHECK_EQ(c.config_writes, 1);
+
+    Diag_Record log[DIAG_EVENT_RING_SIZE];
+    size_t n = hdc.diagnostics().copy_events(log, DIAG_EVENT_RING_SIZE);
+    CHECK_EQ(n, 2 * HDC_I2C_READ_RETRIES + 1);     // NACK, RETRY, NACK
+    CHECK_EQ(log[0].event, DIAG_NACK);
+    CHECK_EQ(log[0].result, PICO_ERROR_GENERIC);
+    CHECK_EQ(log[1].event, DIAG_RETRY);
+
+    // after the conversion time the read goes through and only the sample is counted
+    sleep_us(SIM_HDC_TEMP_14_US);
+    CHECK(hdc.read_raw() != 0);
+    CHECK_EQ(hdc.diagnostics().get_count(DIAG_SAMPLE), 1);
+    CHECK_EQ(hdc.diagnostics().get_count(DIAG_NACK), HDC_I2C_READ_RETRIES + 1);
+
+    hdc.reset_diagnostics();
+    CHECK_EQ(hdc.diagnostics().counters().events_logged, 0);
+}
+
+/*
+ * A stuck bus is counted as a timeout and the read is not retried
+ */
+static void test_timeout(){
+    sim_reset();
+    Stuck_Device stuck;
+    sim_i2c_attach(i2c0, Sim_HDC1080::ADDRESS, &stuck);
+    HDC1080 hdc(i2c0);
+
+    uint64_t start = time_us_64();
+    CHECK_EQ(hdc.read_raw(), 0);
+    CHECK(time_us_64() - start >= HDC_I2C_TIMEOUT_US);
+    CHECK(time_us_64() - start < 2 * HDC_I2C_TIMEOUT_US);
+
+    Diag_Counters c = hdc.diagnostics().counters();
+    CHECK_EQ(c.timeouts, 1);
+    CHECK_EQ(c.retries, 0);
+    CHECK_EQ(c.nacks, 0);
+
+    hdc.set_config(SINGLE_14);
+    CHECK_EQ(hdc.diagnostics().get_count(DIAG_TIMEOUT), 2);
+}
+
+/*
+ * One sample per period, the core sleeps in between and during the conversion
+ */
+static void test_low_power_sampler(){
+    sim_reset();
+    Sim_HDC1080 model;
+    model.set_raw(0x6540, 0x8000);
+    sim_i2c_attach(i2c0, Sim_HDC1080::ADDRESS, &model);
+    HDC1080 hdc(i2c0);
+    HDC1080_Low_Power sampler(&hdc, HIGH_RES, 1000);
+
+    uint16_t t = 0, h = 0;
+    CHECK(sampler.sample(&t, &h));      // the first sample is taken right away
+    CHECK_EQ(t, 0x6540);
+    CHECK_EQ(h, 0x8000);
+    CHECK(time_us_64() >= HDC_BOTH_CONVERSION_US_14);
+    CHECK(time_us_64() < 1000000);
+
+    sim_clear_stats();
+    CHECK(sampler.sample(&t, &h));
+    CHECK(time_us_64() >= 1000000 + HDC_BOTH_CONVERSION_US_14);
+    CHECK(time_us_64() < 1000000 + 2 * HDC_BOTH_CONVERSION_US_14);
+    Sim_Stats stats = sim_stats();
+    CHECK(stats.sleep_cycles > 100 * stats.active_cycles); // asleep for the wait and the conversion
+    CHECK_EQ(model.get_conversions(), 2);
+    CHECK_EQ(hdc.diagnostics().get_count(DIAG_SAMPLE), 2);
+    CHECK_EQ(hdc.diagnostics().get_count(DIAG_NACK), 0);
+
+    // busy past the next period: measured right away, the missed period is skipped
+    sim_charge((uint64_t)1500000 * SIM_CYCLES_PER_US);
+    uint64_t start = time_us_64();
+    CHECK(sampler.sample(&t, &h));
+    CHECK(time_us_64() - start < 2 * HDC_BOTH_CONVERSION_US_14);
+
+    // the sensor is gone: the sample fails and reports zeros
+    sim_i2c_detach(i2c0, Sim_HDC1080::ADDRESS);
+    sampler.restart();
+    CHECK(!sampler.sample(&t, &h));
+    CHECK_EQ(t, 0);
+    CHECK_EQ(h, 0);
+    CHECK(hdc.diagnostics().get_count(DIAG_NACK) > 0);
+}
+
+int main(){
+    RUN_TEST(test_nack_and_retry);
+    RUN_TEST(test_timeout);
+    RUN_TEST(test_low_power_sampler);
+    return TEST_RESULT();
+}
@@ -0,0 +1,19 @@
+/*
+ * Host simulator stand-in for hardware/flash.h. Flash is a RAM array that behaves like NOR flash:
+ *  erase sets a sector to 0xFF, programming can only clear bits. It can be backed by a file with
+ *  sim_flash_attach_file() so contents survive between runs and can be fed to host tools.
+ */
+#ifndef SIM_HARDWARE_FLASH_H
+#define SIM_HARDWARE_FLASH_H
+
+#include "pico.h"
+#include "hardware/regs/addressmap.h"
+
+#define FLASH_PAGE_SIZE (1u << 8)
+#define FLASH_SECTOR_SIZE (1u << 12)
+#define FLASH_BLOCK_SIZE (1u << 16)
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t* data, size_t count);
+
+#endif
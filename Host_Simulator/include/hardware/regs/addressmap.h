@@ -0,0 +1,17 @@
+/*
+ * Host simulator stand-in for hardware/regs/addressmap.h. XIP_BASE points at the simulated flash
+ *  so code reading flash through (const uint8_t*)(XIP_BASE + offset) works unchanged.
+ */
+#ifndef SIM_HARDWARE_REGS_ADDRESSMAP_H
+#define SIM_HARDWARE_REGS_ADDRESSMAP_H
+
+#include <stdint.h>
+
+#ifndef PICO_FLASH_SIZE_BYTES
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+#endif
+
+extern uint8_t sim_flash_memory[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)sim_flash_memory)
+
+#endif
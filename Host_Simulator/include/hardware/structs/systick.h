@@ -0,0 +1,26 @@
+/*
+ * Host simulator stand-in for the Cortex-M0+ SysTick registers. The current value register
+ *  counts down from RVR at clk_sys like on the board, derived from the simulated cycle counter.
+ */
+#ifndef SIM_HARDWARE_STRUCTS_SYSTICK_H
+#define SIM_HARDWARE_STRUCTS_SYSTICK_H
+
+#include "pico.h"
+
+class Sim_Systick_Cvr {
+    public:
+        operator uint32_t() const;                  // read the down counter
+        Sim_Systick_Cvr& operator=(uint32_t value); // any write clears it
+};
+
+typedef struct {
+    uint32_t csr;
+    uint32_t rvr;
+    Sim_Systick_Cvr cvr;
+    uint32_t calib;
+} systick_hw_t;
+
+extern systick_hw_t sim_systick_hw;
+#define systick_hw (&sim_systick_hw)
+
+#endif
@@ -0,0 +1,30 @@
+/*
+ * Host simulator stand-in for hardware/timer.h. The 1MHz timer is derived from the simulated
+ *  clk_sys cycle counter. Four hardware alarms fire their callbacks when the simulated clock
+ *  passes their target, either while the core is busy or while it waits in __wfi().
+ */
+#ifndef SIM_HARDWARE_TIMER_H
+#define SIM_HARDWARE_TIMER_H
+
+#include "pico.h"
+
+#define NUM_TIMERS 4
+
+typedef void (*hardware_alarm_callback_t)(uint alarm_num);
+
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+void busy_wait_us(uint64_t delay_us);
+void busy_wait_us_32(uint32_t delay_us);
+void busy_wait_ms(uint32_t delay_ms);
+void busy_wait_until(absolute_time_t t);
+
+void hardware_alarm_claim(uint alarm_num);
+int hardware_alarm_claim_unused(bool required);
+void hardware_alarm_unclaim(uint alarm_num);
+bool hardware_alarm_is_claimed(uint alarm_num);
+void hardware_alarm_set_callback(uint alarm_num, hardware_alarm_callback_t callback);
+bool hardware_alarm_set_target(uint alarm_num, uint64_t target_us); // true if the target already passed
+void hardware_alarm_cancel(uint alarm_num);
+
+#endif
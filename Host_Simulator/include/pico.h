@@ -0,0 +1,36 @@
+/*
+ * Host simulator stand-in for the Pico SDK pico.h. Only what the libraries in this repo use.
+ */
+#ifndef SIM_PICO_H
+#define SIM_PICO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define PICO_ON_DEVICE 0
+#define PICO_NO_HARDWARE 1
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;   // plain microseconds since boot, like the SDK without PICO_OPAQUE_ABSOLUTE_TIME_T
+
+enum pico_error_codes {
+    PICO_OK = 0,
+    PICO_ERROR_NONE = 0,
+    PICO_ERROR_TIMEOUT = -1,
+    PICO_ERROR_GENERIC = -2,
+    PICO_ERROR_NO_DATA = -3,
+    PICO_ERROR_NOT_PERMITTED = -4,
+    PICO_ERROR_INVALID_ARG = -5,
+    PICO_ERROR_IO = -6,
+};
+
+#define __not_in_flash_func(func_name) func_name
+#define __time_critical_func(func_name) func_name
+#define __no_inline_not_in_flash_func(func_name) func_name
+
+static inline void tight_loop_contents(void) {}
+
+uint get_core_num(void);    // core the simulated code runs on, see sim_set_core()
+
+#endif
@@ -0,0 +1,31 @@
+/*
+ * Host simulator stand-in for pico/multicore.h. Core 1 is not run on its own, multicore_launch_core1()
+ *  only records the launch: tests call the core 1 code themselves (see sim_set_core() in sim.h).
+ *  The inter-core FIFOs hold 8 words each way like the SIO FIFOs. A blocking call that would wait
+ *  forever (nothing else can run meanwhile) is reported and aborts. Lockout only tracks state: a
+ *  core 1 that called multicore_lockout_victim_init() counts as paused between start and end.
+ */
+#ifndef SIM_PICO_MULTICORE_H
+#define SIM_PICO_MULTICORE_H
+
+#include "pico.h"
+
+#define SIM_FIFO_DEPTH 8
+
+void multicore_launch_core1(void (*entry)(void));
+void multicore_reset_core1(void);
+
+bool multicore_fifo_rvalid(void);
+bool multicore_fifo_wready(void);
+void multicore_fifo_push_blocking(uint32_t data);
+bool multicore_fifo_push_timeout_us(uint32_t data, uint64_t timeout_us);
+uint32_t multicore_fifo_pop_blocking(void);
+bool multicore_fifo_pop_timeout_us(uint64_t timeout_us, uint32_t* out);
+void multicore_fifo_drain(void);
+
+void multicore_lockout_victim_init(void);
+bool multicore_lockout_victim_is_initialized(uint core_num);
+void multicore_lockout_start_blocking(void);
+void multicore_lockout_end_blocking(void);
+
+#endif
@@ -0,0 +1,14 @@
+/*
+ * Host simulator stand-in for pico/stdio.h, output goes to the process' stdout
+ */
+#ifndef SIM_PICO_STDIO_H
+#define SIM_PICO_STDIO_H
+
+#include <stdio.h>
+#include "pico.h"
+
+static inline bool stdio_init_all(void) { return true; }
+static inline int putchar_raw(int c) { return putchar(c); }
+static inline void stdio_flush(void) { fflush(stdout); }
+
+#endif
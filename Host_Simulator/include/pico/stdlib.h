@@ -0,0 +1,12 @@
+/*
+ * Host simulator stand-in for pico/stdlib.h
+ */
+#ifndef SIM_PICO_STDLIB_H
+#define SIM_PICO_STDLIB_H
+
+#include "pico.h"
+#include "pico/stdio.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+#endif
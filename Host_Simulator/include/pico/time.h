@@ -0,0 +1,26 @@
+/*
+ * Host simulator stand-in for pico/time.h. Time is the simulated clock, sleeping advances it
+ *  instantly, so simulated runs are fast and repeatable.
+ */
+#ifndef SIM_PICO_TIME_H
+#define SIM_PICO_TIME_H
+
+#include "pico.h"
+#include "hardware/timer.h"
+
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline void update_us_since_boot(absolute_time_t* t, uint64_t us_since_boot) { *t = us_since_boot; }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+static inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) { return t + us; }
+static inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) { return t + (uint64_t)ms * 1000; }
+static inline absolute_time_t make_timeout_time_us(uint64_t us) { return delayed_by_us(get_absolute_time(), us); }
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) { return delayed_by_ms(get_absolute_time(), ms); }
+static inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) { return (int64_t)(to - from); }
+static inline bool time_reached(absolute_time_t t) { return time_us_64() >= t; }
+
+void sleep_until(absolute_time_t target);   // core stays awake (counted as active time)
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+#endif
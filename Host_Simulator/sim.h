@@ -0,0 +1,99 @@
+/*
+ * Host simulator control API. The headers in include/ stand in for the Pico SDK so the drivers
+ *  compile unchanged on Linux, this header lets tests and benchmarks drive the simulated board.
+ *
+ *  Time is a clk_sys cycle counter that only moves when the code calls into the simulated SDK:
+ *  sleeps, bus transfers and GPIO writes each charge a modeled number of cycles. Driver code itself
+ *  is free, so results are repeatable and comparable between versions, not a cycle exact emulation.
+ */
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <hardware/i2c.h>
+
+#define SIM_CLK_SYS_HZ 125000000
+#define SIM_CYCLES_PER_US (SIM_CLK_SYS_HZ / 1000000)
+
+// modeled cost of SDK calls in clk_sys cycles
+#define SIM_GPIO_WRITE_CYCLES 4     /*inlined SIO set/clr store*/
+#define SIM_GPIO_CONFIG_CYCLES 40   /*gpio_init, gpio_set_function, pulls*/
+#define SIM_I2C_CALL_CYCLES 200     /*SDK overhead around one blocking transfer*/
+#define SIM_FLASH_ERASE_US 45000    /*4KB sector erase, typical for the W25Q16 on the Pico*/
+#define SIM_FLASH_PROGRAM_US 700    /*256 byte page program, typical*/
+
+// power model for energy estimates, RP2040 + regulator figures from the Pico datasheet, tune for your board
+#define SIM_SUPPLY_VOLTS 3.3
+#define SIM_ACTIVE_MA 24.0          /*core awake at 125MHz, sleep_ms() included (clocks keep running)*/
+#define SIM_SLEEP_MA 1.3            /*core in WFI with clocks gated except the timer*/
+
+/*
+ * Counters collected since the last sim_reset()
+ */
+struct Sim_Stats {
+    uint64_t active_cycles;     // core awake, including busy waits and sleep_ms()
+    uint64_t sleep_cycles;      // core waiting in __wfi()/__wfe()
+    uint64_t gpio_writes;       // SIO output register writes
+    uint64_t i2c_transactions;  // reads and writes, including failed ones
+    uint64_t i2c_bytes;         // bytes on the wire, address bytes included
+    uint64_t i2c_nacks;         // transfers not acknowledged by the device
+};
+
+/*
+ * A device model on a simulated I2C bus. Return the number of bytes transferred or a negative
+ *  PICO_ERROR_* code, ex. PICO_ERROR_GENERIC to NACK.
+ */
+class Sim_I2C_Device {
+    public:
+        virtual ~Sim_I2C_Device() {}
+        virtual int write(const uint8_t* src, size_t len) = 0;
+        virtual int read(uint8_t* dst, size_t len) = 0;
+};
+
+/*
+ * Observers see bus activity as it happens, ex. to feed a trace recorder. One of each, NULL removes it.
+ *  The I2C observer is called before the transfer's time is charged, with the duration it will take,
+ *  so events reach it in time order even when an alarm fires during the transfer.
+ */
+typedef void (*sim_gpio_observer_fn)(uint64_t cycle, uint32_t outputs, void* ctx);
+typedef void (*sim_i2c_observer_fn)(uint64_t cycle, uint64_t duration_cycles, uint8_t addr, bool read,
+                                    const uint8_t* data, int result, void* ctx);
+
+void sim_reset(void);                   // clock, GPIO, alarms, stats, observers and attached devices back to power on, flash is kept
+
+uint64_t sim_cycles(void);              // clk_sys cycles since reset
+void sim_charge(uint64_t cycles);       // advance the clock with the core awake, fires due alarms
+void sim_sleep_until_us(uint64_t t_us); // advance the clock with the core asleep, fires due alarms
+Sim_Stats sim_stats(void);
+void sim_clear_stats(void);             // zero the counters without touching the clock
+double sim_energy_uj(const Sim_Stats&); // estimated energy for the active and sleep time in the stats
+
+uint32_t sim_gpio_outputs(void);        // current SIO output register
+uint32_t sim_gpio_directions(void);     // current SIO output enable register
+void sim_gpio_set_input(uint gpio, bool level);  // level seen by gpio_get() on an input pin
+void sim_set_gpio_observer(sim_gpio_observer_fn fn, void* ctx);  // called after every SIO output write
+
+void sim_i2c_attach(i2c_inst_t* i2c, uint8_t addr, Sim_I2C_Device* device);
+void sim_i2c_detach(i2c_inst_t* i2c, uint8_t addr);
+void sim_set_i2c_observer(sim_i2c_observer_fn fn, void* ctx);    // called for every transfer, data is what went over the wire
+
+bool sim_flash_attach_file(const char* path);   // load flash from the file (erased if new) and write every change back
+void sim_flash_detach_file(void);               // keep the contents in RAM only
+void sim_flash_erase_chip(void);                // whole flash back to 0xFF
+void sim_flash_fail_program_after(long bytes);  // power loss: the next program writes only this many bytes
+uint64_t sim_flash_erases(void);                // sectors erased since reset
+uint64_t sim_flash_programs(void);              // pages programmed since reset
+uint64_t sim_flash_unsafe_writes(void);         // erases/programs while a launched core 1 was not locked out, on the board it would crash executing from flash
+
+/*
+ * There is one simulated thread of execution. Code meant for core 1 (ex. a tick handler) is run
+ *  by the test between core 0 calls after switching the core number, so the two cores interleave
+ *  at points the test chooses and share the one clock.
+ */
+void sim_set_core(uint core);                   // get_core_num() and the FIFO ends seen by following calls
+bool sim_core1_launched(void);                  // multicore_launch_core1() was called since reset
+bool sim_core1_locked_out(void);                // between multicore_lockout_start_blocking() and _end_blocking()
+uint sim_fifo_level(uint from_core);            // words waiting in the FIFO written by from_core
+
+#endif
@@ -0,0 +1,399 @@
+/*
+ * Host simulator: clock, timer alarms, sleep and GPIO
+ */
+#include "sim.h"
+#include <pico/stdlib.h>
+#include <hardware/sync.h>
+#include <hardware/clocks.h>
+#include <hardware/structs/systick.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Sim_Alarm {
+    bool claimed;
+    bool armed;
+    uint64_t target_us;
+    hardware_alarm_callback_t callback;
+};
+
+static uint64_t cycles;
+static Sim_Stats stats;
+static Sim_Alarm alarms[NUM_TIMERS];
+static bool event_flag;     // set by __sev() or a fired alarm, consumed by __wfe()
+static uint32_t gpio_out, gpio_oe, gpio_in;
+static uint64_t systick_base;   // cycle count when SysTick was last cleared
+static sim_gpio_observer_fn gpio_observer;
+static void* gpio_observer_ctx;
+
+systick_hw_t sim_systick_hw;
+
+void sim_i2c_reset(void);           // sim_i2c.cpp
+void sim_flash_reset_stats(void);   // sim_flash.cpp
+void sim_multicore_reset(void);     // sim_multicore.cpp
+
+void sim_reset(void){
+    cycles = 0;
+    stats = Sim_Stats();
+    for(int i = 0; i < NUM_TIMERS; i++)
+        alarms[i] = Sim_Alarm();
+    event_flag = false;
+    gpio_out = gpio_oe = gpio_in = 0;
+    systick_base = 0;
+    sim_systick_hw.csr = 0;
+    sim_systick_hw.rvr = 0;
+    gpio_observer = NULL;
+    gpio_observer_ctx = NULL;
+    sim_i2c_reset();
+    sim_flash_reset_stats();
+    sim_multicore_reset();
+}
+
+uint64_t sim_cycles(void){
+    return cycles;
+}
+
+Sim_Stats sim_stats(void){
+    return stats;
+}
+
+void sim_clear_stats(void){
+    stats = Sim_Stats();
+}
+
+/*
+ * E = V * (I_active * t_active + I_sleep * t_sleep), mA * us * V = nJ
+ */
+double sim_energy_uj(const Sim_Stats& s){
+    double active_us = (double)s.active_cycles / SIM_CYCLES_PER_US;
+    double sleep_us = (double)s.sleep_cycles / SIM_CYCLES_PER_US;
+    return SIM_SUPPLY_VOLTS * (SIM_ACTIVE_MA * active_us + SIM_SLEEP_MA * sleep_us) / 1000.0;
+}
+
+/*
+ * Called by sim_i2c.cpp for every transfer
+ */
+void sim_count_i2c(size_t bytes, bool nack){
+    stats.i2c_transactions++;
+    stats.i2c_bytes += bytes;
+    if(nack)
+        stats.i2c_nacks++;
+}
+
+/*
+ * Earliest armed alarm due at or before limit_cycles, -1 if none
+ */
+static int next_alarm(uint64_t limit_cycles){
+    int found = -1;
+    for(int i = 0; i < NUM_TIMERS; i++){
+        if(!alarms[i].armed || alarms[i].target_us * SIM_CYCLES_PER_US > limit_cycles)
+            continue;
+        if(found < 0 || alarms[i].target_us < alarms[found].target_us)
+            found = i;
+    }
+    return found;
+}
+
+/*
+ * Move the clock to target, firing alarms in order on the way. Callbacks run at their target time.
+ */
+static void advance_to(uint64_t target, bool sleeping){
+    int a;
+    while((a = next_alarm(target)) >= 0){
+        uint64_t at = alarms[a].target_us * SIM_CYCLES_PER_US;
+        if(at > cycles){
+            if(sleeping)
+                stats.sleep_cycles += at - cycles;
+            else
+                stats.active_cycles += at - cycles;
+            cycles = at;
+        }
+        alarms[a].armed = false;
+        event_flag = true;
+        if(alarms[a].callback)
+            alarms[a].callback(a);
+    }
+    if(target > cycles){
+        if(sleeping)
+            stats.sleep_cycles += target - cycles;
+        else
+            stats.active_cycles += target - cycles;
+        cycles = target;
+    }
+}
+
+void sim_charge(uint64_t n){
+    advance_to(cycles + n, false);
+}
+
+void sim_sleep_until_us(uint64_t t_us){
+    advance_to(t_us * SIM_CYCLES_PER_US, true);
+}
+
+// ---------------------------------------------------------------- timer
+
+uint64_t time_us_64(void){
+    return cycles / SIM_CYCLES_PER_US;
+}
+
+uint32_t time_us_32(void){
+    return (uint32_t)time_us_64();
+}
+
+void busy_wait_us(uint64_t delay_us){
+    sim_charge(delay_us * SIM_CYCLES_PER_US);
+}
+
+void busy_wait_us_32(uint32_t delay_us){
+    busy_wait_us(delay_us);
+}
+
+void busy_wait_ms(uint32_t delay_ms){
+    busy_wait_us((uint64_t)delay_ms * 1000);
+}
+
+void busy_wait_until(absolute_time_t t){
+    if(t > time_us_64())
+        advance_to(t * SIM_CYCLES_PER_US, false);
+}
+
+void hardware_alarm_claim(uint alarm_num){
+    if(alarms[alarm_num].claimed){
+        fprintf(stderr, "[SIM] hardware alarm %u already claimed\n", alarm_num);
+        abort();
+    }
+    alarms[alarm_num].claimed = true;
+}
+
+int hardware_alarm_claim_unused(bool required){
+    for(int i = 0; i < NUM_TIMERS; i++){
+        if(!alarms[i].claimed){
+            alarms[i].claimed = true;
+            return i;
+        }
+    }
+    if(required){
+        fprintf(stderr, "[SIM] no hardware alarms left\n");
+        abort();
+    }
+    return -1;
+}
+
+void hardware_alarm_unclaim(uint alarm_num){
+    alarms[alarm_num] = Sim_Alarm();
+}
+
+bool hardware_alarm_is_claimed(uint alarm_num){
+    return alarms[alarm_num].claimed;
+}
+
+void hardware_alarm_set_callback(uint alarm_num, hardware_alarm_callback_t callback){
+    alarms[alarm_num].callback = callback;
+    if(callback == NULL)
+        alarms[alarm_num].armed = false;
+}
+
+bool hardware_alarm_set_target(uint alarm_num, uint64_t target_us){
+    if(target_us <= time_us_64())
+        return true; // missed, like the SDK the callback is not called
+    alarms[alarm_num].target_us = target_us;
+    alarms[alarm_num].armed = true;
+    return false;
+}
+
+void hardware_alarm_cancel(uint alarm_num){
+    alarms[alarm_num].armed = false;
+}
+
+// ---------------------------------------------------------------- clocks
+
+uint32_t clock_get_hz(enum clock_index clk_index){
+    return clk_index == clk_ref || clk_index == clk_rtc ? 12000000 : SIM_CLK_SYS_HZ;
+}
+
+Sim_Systick_Cvr::operator uint32_t() const {
+    if(!(sim_systick_hw.csr & 1))
+        return 0;
+    uint64_t period = (uint64_t)sim_systick_hw.rvr + 1;
+    return (uint32_t)(sim_systick_hw.rvr - (cycles - systick_base) % period);
+}
+
+Sim_Systick_Cvr& Sim_Systick_Cvr::operator=(uint32_t value){
+    (void)value;
+    systick_base = cycles;
+    return *this;
+}
+
+// ---------------------------------------------------------------- sleep
+
+void sleep_until(absolute_time_t target){
+    if(target > time_us_64())
+        advance_to(target * SIM_CYCLES_PER_US, false);
+}
+
+void sleep_us(uint64_t us){
+    sleep_until(time_us_64() + us);
+}
+
+void sleep_ms(uint32_t ms){
+    sleep_us((uint64_t)ms * 1000);
+}
+
+/*
+ * Sleep until the next alarm. Nothing else can wake the simulated core, so waiting with no alarm
+ *  armed would hang the board: report it instead.
+ */
+void __wfi(void){
+    int a = next_alarm(UINT64_MAX);
+    if(a < 0){
+        fprintf(stderr, "[SIM] __wfi() with no alarm armed, core would sleep forever\n");
+        abort();
+    }
+    advance_to(alarms[a].target_us * SIM_CYCLES_PER_US, true);
+}
+
+void __wfe(void){
+    if(event_flag){
+        event_flag = false;
+        return;
+    }
+    __wfi();
+    event_flag = false;
+}
+
+void __sev(void){
+    event_flag = true;
+}
+
+uint32_t save_and_disable_interrupts(void){
+    return 0;
+}
+
+void restore_interrupts(uint32_t status){
+    (void)status;
+}
+
+// ---------------------------------------------------------------- gpio
+
+void sim_set_gpio_observer(sim_gpio_observer_fn fn, void* ctx){
+    gpio_observer = fn;
+    gpio_observer_ctx = ctx;
+}
+
+static void gpio_write(uint32_t value){
+    gpio_out = value & ((1u << NUM_BANK0_GPIOS) - 1);
+    stats.gpio_writes++;
+    if(gpio_observer)
+        gpio_observer(cycles, gpio_out, gpio_observer_ctx);
+    sim_charge(SIM_GPIO_WRITE_CYCLES);
+}
+
+void gpio_init(uint gpio){
+    gpio_oe &= ~(1u << gpio);
+    gpio_out &= ~(1u << gpio);
+    sim_charge(SIM_GPIO_CONFIG_CYCLES);
+}
+
+void gpio_init_mask(uint gpio_mask){
+    for(uint i = 0; i < NUM_BANK0_GPIOS; i++){
+        if(gpio_mask & (1u << i))
+            gpio_init(i);
+    }
+}
+
+void gpio_deinit(uint gpio){
+    gpio_init(gpio);
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn){
+    (void)gpio;
+    (void)fn;
+    sim_charge(SIM_GPIO_CONFIG_CYCLES);
+}
+
+void gpio_pull_up(uint gpio){
+    gpio_in |= 1u << gpio;
+    sim_charge(SIM_GPIO_CONFIG_CYCLES);
+}
+
+void gpio_pull_down(uint gpio){
+    gpio_in &= ~(1u << gpio);
+    sim_charge(SIM_GPIO_CONFIG_CYCLES);
+}
+
+void gpio_disable_pulls(uint gpio){
+    (void)gpio;
+    sim_charge(SIM_GPIO_CONFIG_CYCLES);
+}
+
+void gpio_set_dir(uint gpio, bool out){
+    if(out)
+        gpio_oe |= 1u << gpio;
+    else
+        gpio_oe &= ~(1u << gpio);
+    sim_charge(SIM_GPIO_WRITE_CYCLES);
+}
+
+void gpio_set_dir_out_masked(uint32_t mask){
+    gpio_oe |= mask;
+    sim_charge(SIM_GPIO_WRITE_CYCLES);
+}
+
+void gpio_set_dir_in_masked(uint32_t mask){
+    gpio_oe &= ~mask;
+    sim_charge(SIM_GPIO_WRITE_CYCLES);
+}
+
+void gpio_set_dir_masked(uint32_t mask, uint32_t value){
+    gpio_oe = (gpio_oe & ~mask) | (value & mask);
+    sim_charge(SIM_GPIO_WRITE_CYCLES);
+}
+
+void gpio_put(uint gpio, bool value){
+    if(value)
+        gpio_write(gpio_out | (1u << gpio));
+    else
+        gpio_write(gpio_out & ~(1u << gpio));
+}
+
+void gpio_put_all(uint32_t value){
+    gpio_write(value);
+}
+
+void gpio_put_masked(uint32_t mask, uint32_t value){
+    gpio_write((gpio_out & ~mask) | (value & mask));
+}
+
+void gpio_set_mask(uint32_t mask){
+    gpio_write(gpio_out | mask);
+}
+
+void gpio_clr_mask(uint32_t mask){
+    gpio_write(gpio_out & ~mask);
+}
+
+void gpio_xor_mask(uint32_t mask){
+    gpio_write(gpio_out ^ mask);
+}
+
+bool gpio_get(uint gpio){
+    return (gpio_get_all() >> gpio) & 1u;
+}
+
+uint32_t gpio_get_all(void){
+    return (gpio_out & gpio_oe) | (gpio_in & ~gpio_oe);
+}
+
+uint32_t sim_gpio_outputs(void){
+    return gpio_out;
+}
+
+uint32_t sim_gpio_directions(void){
+    return gpio_oe;
+}
+
+void sim_gpio_set_input(uint gpio, bool level){
+    if(level)
+        gpio_in |= 1u << gpio;
+    else
+        gpio_in &= ~(1u << gpio);
+}
@@ -0,0 +1,124 @@
+/*
+ * Host simulator: NOR flash, optionally backed by a file
+ */
+#include "sim.h"
+#include <hardware/flash.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+uint8_t sim_flash_memory[PICO_FLASH_SIZE_BYTES];
+
+static FILE* backing;           // write-through copy of the flash, NULL when not attached
+static long program_limit = -1; // bytes the next program may write before "power loss", -1 = no limit
+static uint64_t erases, programs;
+static uint64_t unsafe_writes;
+
+/*
+ * Copy a changed range to the backing file so it always matches the simulated flash
+ */
+static void write_through(uint32_t offs, size_t count){
+    if(backing == NULL)
+        return;
+    fseek(backing, (long)offs, SEEK_SET);
+    fwrite(&sim_flash_memory[offs], 1, count, backing);
+    fflush(backing);
+}
+
+/*
+ * Flash is not touched by sim_reset(), like a reboot, only the counters start over
+ */
+void sim_flash_reset_stats(void){
+    program_limit = -1;
+    erases = programs = 0;
+    unsafe_writes = 0;
+}
+
+/*
+ * XIP is off while flash is written, a core still running (from flash) would fault
+ */
+static void check_other_core(void){
+    if(sim_core1_launched() && !sim_core1_locked_out())
+        unsafe_writes++;
+}
+
+void sim_flash_erase_chip(void){
+    memset(sim_flash_memory, 0xFF, sizeof(sim_flash_memory));
+    write_through(0, sizeof(sim_flash_memory));
+}
+
+// a new chip comes erased
+static struct Sim_Flash_Init {
+    Sim_Flash_Init(){ memset(sim_flash_memory, 0xFF, sizeof(sim_flash_memory)); }
+} flash_init;
+
+static void check_range(uint32_t offs, size_t count, uint32_t align, const char* what){
+    if(offs % align != 0 || count % align != 0 || (uint64_t)offs + count > PICO_FLASH_SIZE_BYTES){
+        fprintf(stderr, "[SIM] %s(0x%X, %zu) not aligned to %u or out of range\n", what, offs, count, align);
+        abort();
+    }
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count){
+    check_range(flash_offs, count, FLASH_SECTOR_SIZE, "flash_range_erase");
+    check_other_core();
+    memset(&sim_flash_memory[flash_offs], 0xFF, count);
+    write_through(flash_offs, count);
+    erases += count / FLASH_SECTOR_SIZE;
+    sim_charge((uint64_t)SIM_FLASH_ERASE_US * SIM_CYCLES_PER_US * (count / FLASH_SECTOR_SIZE));
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t* data, size_t count){
+    check_range(flash_offs, count, FLASH_PAGE_SIZE, "flash_range_program");
+    check_other_core();
+    size_t n = count;
+    if(program_limit >= 0 && (size_t)program_limit < n){
+        n = (size_t)program_limit; // power lost part way through
+        program_limit = 0;
+    }
+    for(size_t i = 0; i < n; i++)
+        sim_flash_memory[flash_offs + i] &= data[i]; // NOR: programming only clears bits
+    write_through(flash_offs, count);
+    programs += count / FLASH_PAGE_SIZE;
+    sim_charge((uint64_t)SIM_FLASH_PROGRAM_US * SIM_CYCLES_PER_US * (count / FLASH_PAGE_SIZE));
+}
+
+bool sim_flash_attach_file(const char* path){
+    sim_flash_detach_file();
+    backing = fopen(path, "r+b");
+    if(backing != NULL){
+        size_t n = fread(sim_flash_memory, 1, sizeof(sim_flash_memory), backing);
+        if(n < sizeof(sim_flash_memory))
+            memset(&sim_flash_memory[n], 0xFF, sizeof(sim_flash_memory) - n);
+        return true;
+    }
+
+    backing = fopen(path, "w+b"); // new image starts erased
+    if(backing == NULL)
+        return false;
+    memset(sim_flash_memory, 0xFF, sizeof(sim_flash_memory));
+    write_through(0, sizeof(sim_flash_memory));
+    return true;
+}
+
+void sim_flash_detach_file(void){
+    if(backing != NULL)
+        fclose(backing);
+    backing = NULL;
+}
+
+void sim_flash_fail_program_after(long bytes){
+    program_limit = bytes;
+}
+
+uint64_t sim_flash_erases(void){
+    return erases;
+}
+
+uint64_t sim_flash_programs(void){
+    return programs;
+}
+
+uint64_t sim_flash_unsafe_writes(void){
+    return unsafe_writes;
+}
@@ -0,0 +1,117 @@
+/*
+ * Host simulator model of the HDC1080 temperature and humidity sensor
+ */
+#include "sim_hdc1080.h"
+
+// configuration register bits (datasheet 8.6.3)
+#define CFG_RESET 0x8000
+#define CFG_MODE 0x1000     /*1 = temperature and humidity in sequence*/
+#define CFG_TRES 0x0400     /*1 = 11 bit temperature*/
+#define CFG_HRES 0x0300     /*00 = 14, 01 = 11, 10 = 8 bit humidity*/
+
+Sim_HDC1080::Sim_HDC1080(){
+    pointer = 0x00;
+    config = 0x1000;
+    ready_at_us = 0;
+    conversions = 0;
+    temp_out = hum_out = 0;
+    set_environment(22.5, 45.0);
+}
+
+/*
+ * Set the conditions the sensor will report, inverse of the datasheet transfer functions
+ */
+void Sim_HDC1080::set_environment(float celsius, float relative_humidity){
+    double t = (celsius + 40.0) / 165.0 * 65536.0;
+    double h = relative_humidity / 100.0 * 65536.0;
+    set_raw(t >= 65535.0 ? 0xFFFF : (t <= 0 ? 0 : (uint16_t)t),
+            h >= 65535.0 ? 0xFFFF : (h <= 0 ? 0 : (uint16_t)h));
+}
+
+void Sim_HDC1080::set_raw(uint16_t temp_raw, uint16_t hum_raw){
+    temp_env = temp_raw;
+    hum_env = hum_raw;
+}
+
+uint16_t Sim_HDC1080::get_config(void) const {
+    return config;
+}
+
+uint32_t Sim_HDC1080::get_conversions(void) const {
+    return conversions;
+}
+
+/*
+ * Pointer write to 0x00 or 0x01 triggers a measurement, in sequence mode 0x00 measures both
+ */
+void Sim_HDC1080::start_conversion(void){
+    bool temp_11 = config & CFG_TRES;
+    uint16_t hres = config & CFG_HRES;
+    uint16_t temp_mask = temp_11 ? 0xFFE0 : 0xFFFC;
+    uint16_t hum_mask = hres == 0x0100 ? 0xFFE0 : (hres == 0x0200 ? 0xFF00 : 0xFFFC);
+    uint32_t temp_us = temp_11 ? SIM_HDC_TEMP_11_US : SIM_HDC_TEMP_14_US;
+    uint32_t hum_us = hres == 0x0100 ? SIM_HDC_HUM_11_US : (hres == 0x0200 ? SIM_HDC_HUM_8_US : SIM_HDC_HUM_14_US);
+
+    uint32_t duration;
+    if((config & CFG_MODE) && pointer == 0x00){
+        duration = temp_us + hum_us;
+        temp_out = temp_env & temp_mask;
+        hum_out = hum_env & hum_mask;
+    }else if(pointer == 0x00){
+        duration = temp_us;
+        temp_out = temp_env & temp_mask;
+    }else{
+        duration = hum_us;
+        hum_out = hum_env & hum_mask;
+    }
+    ready_at_us = time_us_64() + duration;
+    conversions++;
+}
+
+int Sim_HDC1080::write(const uint8_t* src, size_t len){
+    if(len == 0)
+        return 0;
+    pointer = src[0];
+
+    if(pointer == 0x02 && len >= 3){
+        config = (uint16_t)(src[1] << 8 | src[2]);
+        if(config & CFG_RESET)
+            config = 0x1000;
+    }else if(len == 1 && (pointer == 0x00 || pointer == 0x01)){
+        start_conversion();
+    }
+    return (int)len;
+}
+
+int Sim_HDC1080::read(uint8_t* dst, size_t len){
+    uint16_t words[2] = {0, 0};
+    size_t n_words = 1;
+
+    switch(pointer){
+        case 0x00:
+        case 0x01:
+            if(time_us_64() < ready_at_us)
+                return PICO_ERROR_GENERIC; // conversion still running, sensor NACKs
+            if(pointer == 0x00){
+                words[0] = temp_out;
+                words[1] = hum_out;
+                n_words = (config & CFG_MODE) ? 2 : 1;
+            }else{
+                words[0] = hum_out;
+            }
+            break;
+        case 0x02: words[0] = config; break;
+        case 0xFB: words[0] = 0x0123; break;   // serial ID, arbitrary but fixed
+        case 0xFC: words[0] = 0x4567; break;
+        case 0xFD: words[0] = 0x8900; break;
+        case 0xFE: words[0] = 0x5449; break;   // manufacturer ID, Texas Instruments
+        case 0xFF: words[0] = 0x1050; break;   // device ID
+        default: return PICO_ERROR_GENERIC;
+    }
+
+    for(size_t i = 0; i < len; i++){
+        size_t w = (i / 2) % n_words;
+        dst[i] = (i % 2 == 0) ? (uint8_t)(words[w] >> 8) : (uint8_t)(words[w] & 0xFF);
+    }
+    return (int)len;
+}
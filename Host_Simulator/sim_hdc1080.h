@@ -0,0 +1,43 @@
+/*
+ * Host simulator model of the HDC1080 temperature and humidity sensor.
+ *  Conversions take the typical times from the datasheet (table 7.5), reading a result register
+ *  before the conversion finished is NACKed like on the real part. Results are quantized to the
+ *  resolution selected in the configuration register.
+ */
+#ifndef SIM_HDC1080_H
+#define SIM_HDC1080_H
+
+#include "sim.h"
+
+// typical conversion times in microseconds
+#define SIM_HDC_TEMP_14_US 6350
+#define SIM_HDC_TEMP_11_US 3650
+#define SIM_HDC_HUM_14_US 6500
+#define SIM_HDC_HUM_11_US 3850
+#define SIM_HDC_HUM_8_US 2500
+
+class Sim_HDC1080 : public Sim_I2C_Device {
+    private:
+        uint8_t pointer;        // register selected by the last write
+        uint16_t config;        // configuration register
+        uint16_t temp_env, hum_env;     // what the sensor would measure right now
+        uint16_t temp_out, hum_out;     // latched conversion results
+        uint64_t ready_at_us;   // when the running conversion finishes
+        uint32_t conversions;   // conversions started since construction
+
+        void start_conversion(void);
+
+    public:
+        static const uint8_t ADDRESS = 0x40;
+
+        Sim_HDC1080();
+        void set_environment(float celsius, float relative_humidity);
+        void set_raw(uint16_t temp_raw, uint16_t hum_raw);
+        uint16_t get_config(void) const;
+        uint32_t get_conversions(void) const;
+
+        int write(const uint8_t* src, size_t len);
+        int read(uint8_t* dst, size_t len);
+};
+
+#endif
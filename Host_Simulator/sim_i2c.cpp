@@ -0,0 +1,130 @@
+/*
+ * Host simulator: I2C buses. A transfer costs the SDK call overhead plus the wire time of the
+ *  address and data bytes (9 clocks each) and the start/stop conditions at the bus baudrate.
+ */
+#include "sim.h"
+
+#define SIM_I2C_MAX_DEVICES 8 /*devices per bus*/
+
+struct Sim_I2C_Slot {
+    uint8_t addr;
+    Sim_I2C_Device* device;
+};
+
+i2c_inst_t i2c0_inst = {0, 100 * 1000};
+i2c_inst_t i2c1_inst = {1, 100 * 1000};
+
+static Sim_I2C_Slot slots[2][SIM_I2C_MAX_DEVICES];
+static sim_i2c_observer_fn observer;
+static void* observer_ctx;
+
+void sim_count_i2c(size_t bytes, bool nack); // sim_core.cpp owns the stats
+
+void sim_i2c_reset(void){
+    for(int b = 0; b < 2; b++){
+        for(int i = 0; i < SIM_I2C_MAX_DEVICES; i++)
+            slots[b][i] = Sim_I2C_Slot();
+    }
+    i2c0_inst.baudrate = 100 * 1000;
+    i2c1_inst.baudrate = 100 * 1000;
+    observer = NULL;
+    observer_ctx = NULL;
+}
+
+void sim_set_i2c_observer(sim_i2c_observer_fn fn, void* ctx){
+    observer = fn;
+    observer_ctx = ctx;
+}
+
+void sim_i2c_attach(i2c_inst_t* i2c, uint8_t addr, Sim_I2C_Device* device){
+    sim_i2c_detach(i2c, addr);
+    for(int i = 0; i < SIM_I2C_MAX_DEVICES; i++){
+        if(slots[i2c->index][i].device == NULL){
+            slots[i2c->index][i].addr = addr;
+            slots[i2c->index][i].device = device;
+            return;
+        }
+    }
+}
+
+void sim_i2c_detach(i2c_inst_t* i2c, uint8_t addr){
+    for(int i = 0; i < SIM_I2C_MAX_DEVICES; i++){
+        if(slots[i2c->index][i].device != NULL && slots[i2c->index][i].addr == addr)
+            slots[i2c->index][i] = Sim_I2C_Slot();
+    }
+}
+
+static Sim_I2C_Device* find_device(i2c_inst_t* i2c, uint8_t addr){
+    for(int i = 0; i < SIM_I2C_MAX_DEVICES; i++){
+        if(slots[i2c->index][i].device != NULL && slots[i2c->index][i].addr == addr)
+            return slots[i2c->index][i].device;
+    }
+    return NULL;
+}
+
+/*
+ * SDK overhead plus the wire time for the address byte and data_bytes
+ */
+static uint64_t transfer_cycles(i2c_inst_t* i2c, size_t data_bytes){
+    uint64_t bits = 2 + 9 * (1 + (uint64_t)data_bytes); // start + stop, 8 bits + ACK per byte
+    return SIM_I2C_CALL_CYCLES + bits * SIM_CLK_SYS_HZ / i2c->baudrate;
+}
+
+/*
+ * Common path for reads and writes, device is NULL or NACKs -> only the address byte went out
+ */
+static int transfer(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, uint8_t* dst, size_t len, uint timeout_us){
+    Sim_I2C_Device* device = find_device(i2c, addr);
+    int result = PICO_ERROR_GENERIC;
+    if(device != NULL)
+        result = src != NULL ? device->write(src, len) : device->read(dst, len);
+
+    uint64_t charge;
+    if(result == PICO_ERROR_TIMEOUT){
+        sim_count_i2c(1, false);
+        charge = SIM_I2C_CALL_CYCLES + (uint64_t)timeout_us * SIM_CYCLES_PER_US;
+    }else if(result < 0){
+        sim_count_i2c(1, true);
+        charge = transfer_cycles(i2c, 0);
+    }else{
+        sim_count_i2c(1 + len, false);
+        charge = transfer_cycles(i2c, len);
+    }
+    if(observer)
+        observer(sim_cycles(), charge, addr, src == NULL, src != NULL ? src : dst, result, observer_ctx);
+    sim_charge(charge);
+    return result;
+}
+
+uint i2c_init(i2c_inst_t* i2c, uint baudrate){
+    return i2c_set_baudrate(i2c, baudrate);
+}
+
+void i2c_deinit(i2c_inst_t* i2c){
+    (void)i2c;
+}
+
+uint i2c_set_baudrate(i2c_inst_t* i2c, uint baudrate){
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len, bool nostop){
+    (void)nostop;
+    return transfer(i2c, addr, src, NULL, len, 0);
+}
+
+int i2c_read_blocking(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len, bool nostop){
+    (void)nostop;
+    return transfer(i2c, addr, NULL, dst, len, 0);
+}
+
+int i2c_write_timeout_us(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len, bool nostop, uint timeout_us){
+    (void)nostop;
+    return transfer(i2c, addr, src, NULL, len, timeout_us);
+}
+
+int i2c_read_timeout_us(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len, bool nostop, uint timeout_us){
+    (void)nostop;
+    return transfer(i2c, addr, NULL, dst, len, timeout_us);
+}
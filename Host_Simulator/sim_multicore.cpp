@@ -0,0 +1,145 @@
+/*
+ * Host simulator: core number and inter-core FIFOs
+ */
+#include "sim.h"
+#include <pico/multicore.h>
+#include <pico/time.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Sim_Fifo {
+    uint32_t word[SIM_FIFO_DEPTH];
+    uint head;  // next word to read
+    uint count;
+};
+
+static uint current_core;
+static bool core1_launched;
+static bool victim[2];          // multicore_lockout_victim_init() called on the core
+static bool locked_out;
+static Sim_Fifo fifo[2]; // indexed by the writing core
+
+void sim_multicore_reset(void){
+    current_core = 0;
+    core1_launched = false;
+    victim[0] = victim[1] = false;
+    locked_out = false;
+    fifo[0] = Sim_Fifo();
+    fifo[1] = Sim_Fifo();
+}
+
+void sim_set_core(uint core){
+    current_core = core & 1;
+}
+
+bool sim_core1_launched(void){
+    return core1_launched;
+}
+
+uint sim_fifo_level(uint from_core){
+    return fifo[from_core & 1].count;
+}
+
+uint get_core_num(void){
+    return current_core;
+}
+
+void multicore_launch_core1(void (*entry)(void)){
+    (void)entry;
+    core1_launched = true;
+}
+
+void multicore_reset_core1(void){
+    core1_launched = false;
+    victim[1] = false;
+    locked_out = false;
+    fifo[0] = Sim_Fifo();
+    fifo[1] = Sim_Fifo();
+}
+
+static Sim_Fifo* tx(void){
+    return &fifo[current_core];
+}
+
+static Sim_Fifo* rx(void){
+    return &fifo[current_core ^ 1];
+}
+
+bool multicore_fifo_rvalid(void){
+    return rx()->count > 0;
+}
+
+bool multicore_fifo_wready(void){
+    return tx()->count < SIM_FIFO_DEPTH;
+}
+
+bool multicore_fifo_push_timeout_us(uint32_t data, uint64_t timeout_us){
+    Sim_Fifo* f = tx();
+    if(f->count == SIM_FIFO_DEPTH){
+        sleep_us(timeout_us); // the other core never runs meanwhile, so it stays full
+        return false;
+    }
+    f->word[(f->head + f->count) % SIM_FIFO_DEPTH] = data;
+    f->count++;
+    return true;
+}
+
+void multicore_fifo_push_blocking(uint32_t data){
+    if(!multicore_fifo_wready()){
+        fprintf(stderr, "[SIM] core %u pushed to a full FIFO, it would block forever\n", current_core);
+        abort();
+    }
+    multicore_fifo_push_timeout_us(data, 0);
+}
+
+bool multicore_fifo_pop_timeout_us(uint64_t timeout_us, uint32_t* out){
+    Sim_Fifo* f = rx();
+    if(f->count == 0){
+        sleep_us(timeout_us);
+        return false;
+    }
+    *out = f->word[f->head];
+    f->head = (f->head + 1) % SIM_FIFO_DEPTH;
+    f->count--;
+    return true;
+}
+
+uint32_t multicore_fifo_pop_blocking(void){
+    uint32_t data;
+    if(!multicore_fifo_pop_timeout_us(0, &data)){
+        fprintf(stderr, "[SIM] core %u popped an empty FIFO, it would block forever\n", current_core);
+        abort();
+    }
+    return data;
+}
+
+void multicore_fifo_drain(void){
+    *rx() = Sim_Fifo();
+}
+
+void multicore_lockout_victim_init(void){
+    victim[current_core] = true;
+}
+
+bool multicore_lockout_victim_is_initialized(uint core_num){
+    return victim[core_num & 1];
+}
+
+bool sim_core1_locked_out(void){
+    return locked_out;
+}
+
+/*
+ * The other core never answers unless it registered as a victim, on the board this waits forever
+ */
+void multicore_lockout_start_blocking(void){
+    if(!victim[current_core ^ 1]){
+        fprintf(stderr, "[SIM] core %u started a lockout, the other core is no lockout victim, it would block forever\n", current_core);
+        abort();
+    }
+    locked_out = true;
+}
+
+void multicore_lockout_end_blocking(void){
+    locked_out = false;
+}
@@ -0,0 +1,35 @@
+/*
+ * Minimal checks for the host tests, each test is a plain executable run by ctest.
+ *  A failed CHECK prints where it failed and the test exits non-zero at the end.
+ */
+#ifndef SIM_TEST_H
+#define SIM_TEST_H
+
+#include <stdio.h>
+
+static int sim_test_failures = 0;
+
+#define CHECK(cond) do { \
+        if(!(cond)){ \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            sim_test_failures++; \
+        } \
+    } while(0)
+
+#define CHECK_EQ(a, b) do { \
+        long long check_a = (long long)(a), check_b = (long long)(b); \
+        if(check_a != check_b){ \
+            fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, check_a, check_b); \
+            sim_test_failures++; \
+        } \
+    } while(0)
+
+#define RUN_TEST(fn) do { \
+        int before = sim_test_failures; \
+        fn(); \
+        printf("%s %s\n", sim_test_failures == before ? "[PASS]" : "[FAIL]", #fn); \
+    } while(0)
+
+#define TEST_RESULT() (sim_test_failures == 0 ? 0 : 1)
+
+#endif
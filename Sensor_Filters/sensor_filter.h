@@ -0,0 +1,220 @@
+/*
+ * Allocation-free integer filters for raw sensor codes (ex. HDC1080 uint16_t readings), applied
+ *  before the conversion to float so oversampling doesn't cost soft-float cycles or float buffers.
+ *
+ *  Every filter has the same interface:
+ *      bool push(uint16_t in, uint16_t* out)   feed one sample, true when *out holds a new output
+ *      void reset(void)                        forget the history
+ *  so they can be chained with Filter_Chain, ex. spike rejection then averaging then decimation:
+ *      Filter_Chain<Median_Filter<3>, IIR_Filter<2>, Decimator<4>> temp_filter;
+ *
+ *  State is kept per channel in the object, sizes are noted on each class.
+ */
+#ifndef SENSOR_FILTER_H
+#define SENSOR_FILTER_H
+
+#include <stdint.h>
+
+/*
+ * Box average of the last N samples. State: 2*N + 6 bytes.
+ *  Until N samples have been seen the average covers the samples so far.
+ */
+template<uint8_t N>
+class Moving_Average {
+    static_assert(N >= 1, "window must hold at least one sample");
+    private:
+        uint16_t history[N];
+        uint32_t sum;
+        uint8_t index;
+        uint8_t filled;
+
+    public:
+        Moving_Average(){ reset(); }
+
+        void reset(void){
+            for(uint8_t i = 0; i < N; i++)
+                history[i] = 0;
+            sum = 0;
+            index = 0;
+            filled = 0;
+        }
+
+        bool push(uint16_t in, uint16_t* out){
+            sum = sum - history[index] + in;
+            history[index] = in;
+            index = index + 1 == N ? 0 : index + 1;
+            if(filled < N)
+                filled++;
+            *out = (uint16_t)((sum + filled / 2) / filled);
+            return true;
+        }
+};
+
+/*
+ * Median of the last N samples, rejects spikes shorter than N/2+1 samples. N must be odd and small,
+ *  the window is sorted on every sample. State: 2*N + 2 bytes.
+ */
+template<uint8_t N>
+class Median_Filter {
+    static_assert(N % 2 == 1 && N <= 15, "median window must be odd and at most 15");
+    private:
+        uint16_t history[N];
+        uint8_t index;
+        uint8_t filled;
+
+    public:
+        Median_Filter(){ reset(); }
+
+        void reset(void){
+            index = 0;
+            filled = 0;
+        }
+
+        bool push(uint16_t in, uint16_t* out){
+            history[index] = in;
+            index = index + 1 == N ? 0 : index + 1;
+            if(filled < N)
+                filled++;
+
+            // insertion sort of a copy, N is small so this beats anything clever
+            uint16_t sorted[N];
+            for(uint8_t i = 0; i < filled; i++){
+                uint16_t v = history[i];
+                int8_t j = (int8_t)i - 1;
+                while(j >= 0 && sorted[j] > v){
+                    sorted[j + 1] = sorted[j];
+                    j--;
+                }
+                sorted[j + 1] = v;
+            }
+            *out = sorted[filled / 2];
+            return true;
+        }
+};
+
+/*
+ * Exponential moving average, y += (x - y) / 2^SHIFT. Higher SHIFT = smoother and slower.
+ *  Kept as y * 2^SHIFT so no resolution is lost, the first sample sets the starting value. The
+ *  update subtracts the rounded output, so a constant input is reached exactly from either side.
+ *  State: 5 bytes (8 with padding).
+ */
+template<uint8_t SHIFT>
+class IIR_Filter {
+    static_assert(SHIFT >= 1 && SHIFT <= 15, "SHIFT must be between 1 and 15");
+    private:
+        uint32_t acc;   // y * 2^SHIFT
+        bool primed;
+
+    public:
+        IIR_Filter(){ reset(); }
+
+        void reset(void){
+            acc = 0;
+            primed = false;
+        }
+
+        bool push(uint16_t in, uint16_t* out){
+            if(!primed){
+                acc = (uint32_t)in << SHIFT;
+                primed = true;
+            }else{
+                uint32_t y = (acc + (1u << (SHIFT - 1))) >> SHIFT;
+                acc = acc + in - y;     // y <= acc, never negative
+            }
+            *out = (uint16_t)((acc + (1u << (SHIFT - 1))) >> SHIFT);
+            return true;
+        }
+};
+
+/*
+ * Average every N samples into one output, use after the other filters to lower the output rate.
+ *  State: 5 bytes (8 with padding).
+ */
+template<uint8_t N>
+class Decimator {
+    static_assert(N >= 1, "decimate by at least 1");
+    private:
+        uint32_t sum;
+        uint8_t count;
+
+    public:
+        Decimator(){ reset(); }
+
+        void reset(void){
+            sum = 0;
+            count = 0;
+        }
+
+        bool push(uint16_t in, uint16_t* out){
+            sum += in;
+            if(++count < N)
+                return false;
+            *out = (uint16_t)((sum + N / 2) / N);
+            sum = 0;
+            count = 0;
+            return true;
+        }
+};
+
+/*
+ * Runs a sample through each stage in order, stops early when a stage holds its output back
+ *  (a Decimator waiting for more samples).
+ */
+template<typename... Stages>
+class Filter_Chain;
+
+template<>
+class Filter_Chain<> {
+    public:
+        void reset(void){}
+        bool push(uint16_t in, uint16_t* out){
+            *out = in;
+            return true;
+        }
+};
+
+template<typename First, typename... Rest>
+class Filter_Chain<First, Rest...> {
+    private:
+        First first;
+        Filter_Chain<Rest...> rest;
+
+    public:
+        void reset(void){
+            first.reset();
+            rest.reset();
+        }
+
+        bool push(uint16_t in, uint16_t* out){
+            uint16_t mid;
+            if(!first.push(in, &mid))
+                return false;
+            return rest.push(mid, out);
+        }
+};
+
+/*
+ * Temperature and humidity filtered side by side, both chains must output at the same rate
+ *  (same decimation) so the pair stays together. Drops in right after read_both_raw():
+ *      if(hdc_filter.push(temp_raw, hum_raw, &temp_raw, &hum_raw)) use(temp_raw, hum_raw);
+ */
+template<typename Temp_Chain, typename Hum_Chain>
+class Filter_Pair {
+    private:
+        Temp_Chain temp;
+        Hum_Chain hum;
+
+    public:
+        void reset(void){
+            temp.reset();
+            hum.reset();
+        }
+
+        bool push(uint16_t temp_in, uint16_t hum_in, uint16_t* temp_out, uint16_t* hum_out){
+            bool t_ready = temp.push(temp_in, temp_out);
+            bool h_ready = hum.push(hum_in, hum_out);
+            return t_ready && h_ready;
+        }
+};
+
+#endif
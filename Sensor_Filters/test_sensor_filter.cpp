@@ -0,0 +1,134 @@
+/*
+ * Tests for the raw code filters
+ */
+#include "sim_test.h"
+#include "sensor_filter.h"
+
+static_assert(sizeof(IIR_Filter<4>) <= 8, "IIR state should stay a few bytes");
+static_assert(sizeof(Decimator<8>) <= 8, "decimator state should stay a few bytes");
+static_assert(sizeof(Median_Filter<3>) <= 8, "median-of-3 state should stay a few bytes");
+static_assert(sizeof(Moving_Average<4>) <= 16, "moving average state is the window plus a sum");
+
+static void test_moving_average(){
+    Moving_Average<4> f;
+    uint16_t out = 0;
+
+    CHECK(f.push(100, &out));
+    CHECK_EQ(out, 100);     // warm-up averages what it has
+    f.push(200, &out);
+    CHECK_EQ(out, 150);
+    f.push(300, &out);
+    f.push(400, &out);
+    CHECK_EQ(out, 250);
+    f.push(500, &out);      // 100 falls out of the window
+    CHECK_EQ(out, 350);
+
+    for(int i = 0; i < 10; i++)
+        f.push(65535, &out);
+    CHECK_EQ(out, 65535);   // no overflow at full scale
+
+    f.reset();
+    f.push(7, &out);
+    CHECK_EQ(out, 7);
+}
+
+static void test_median_rejects_spike(){
+    Median_Filter<5> f;
+    uint16_t out = 0;
+    const uint16_t input[] = {1000, 1002, 1001, 60000, 999, 1003, 0, 1000};
+
+    for(uint16_t v : input){
+        CHECK(f.push(v, &out));
+        CHECK(out >= 999 && out <= 1003);
+    }
+}
+
+static void test_median_of_3_order(){
+    Median_Filter<3> f;
+    uint16_t out = 0;
+    f.push(30, &out);
+    f.push(10, &out);
+    f.push(20, &out);
+    CHECK_EQ(out, 20);
+    f.push(5, &out);        // window 10, 20, 5
+    CHECK_EQ(out, 10);
+}
+
+static void test_iir(){
+    IIR_Filter<3> f;
+    uint16_t out = 0;
+
+    f.push(1000, &out);
+    CHECK_EQ(out, 1000);    // first sample primes the filter
+
+    for(int i = 0; i < 200; i++)
+        f.push(2000, &out);
+    CHECK_EQ(out, 2000);    // converges exactly for a constant input, rising
+
+    f.push(2800, &out);     // one step moves 1/8 of the way
+    CHECK_EQ(out, 2100);
+
+    for(int i = 0; i < 200; i++)
+        f.push(1000, &out);
+    CHECK_EQ(out, 1000);    // and falling, truncation used to stop 1 LSB above
+
+    IIR_Filter<8> smooth;
+    smooth.push(30000, &out);
+    for(int i = 0; i < 5000; i++)
+        smooth.push(20000, &out);
+    CHECK_EQ(out, 20000);
+    for(int i = 0; i < 5000; i++)
+        smooth.push(30000, &out);
+    CHECK_EQ(out, 30000);
+
+    IIR_Filter<15> slow;
+    for(int i = 0; i < 10; i++)
+        slow.push(65535, &out);
+    CHECK_EQ(out, 65535);   // no overflow with the largest shift
+}
+
+static void test_decimator(){
+    Decimator<4> f;
+    uint16_t out = 0;
+    int outputs = 0;
+
+    for(int i = 0; i < 16; i++){
+        if(f.push((uint16_t)(i % 4 * 10), &out)){
+            outputs++;
+            CHECK_EQ(out, 15);  // (0 + 10 + 20 + 30) / 4
+        }
+    }
+    CHECK_EQ(outputs, 4);
+}
+
+static void test_chain_and_pair(){
+    Filter_Chain<Median_Filter<3>, IIR_Filter<1>, Decimator<2>> chain;
+    uint16_t out = 0;
+    int outputs = 0;
+
+    for(int i = 0; i < 20; i++){
+        uint16_t in = i == 7 ? 50000 : 500;  // single spike is removed before averaging
+        if(chain.push(in, &out)){
+            outputs++;
+            CHECK_EQ(out, 500);
+        }
+    }
+    CHECK_EQ(outputs, 10);
+
+    Filter_Pair<Filter_Chain<Decimator<2>>, Filter_Chain<Decimator<2>>> pair;
+    uint16_t t = 0, h = 0;
+    CHECK(!pair.push(100, 200, &t, &h));
+    CHECK(pair.push(300, 400, &t, &h));
+    CHECK_EQ(t, 200);
+    CHECK_EQ(h, 300);
+}
+
+int main(){
+    RUN_TEST(test_moving_average);
+    RUN_TEST(test_median_rejects_spike);
+    RUN_TEST(test_median_of_3_order);
+    RUN_TEST(test_iir);
+    RUN_TEST(test_decimator);
+    RUN_TEST(test_chain_and_pair);
+    return TEST_RESULT();
+}
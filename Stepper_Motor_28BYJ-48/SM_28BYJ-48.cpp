@@ -1,6 +1,6 @@
 #include "SM_28BYJ-48.h"
 #include <pico/stdlib.h>
-#include <stdio.h>
+#include "driver_instrument.h"
 
 /*
  * Construct a new object with pin definitions and default states.
@@ -14,6 +14,7 @@ SM_28BYJ_48::SM_28BYJ_48(int in1, int in2, int in3, int in4){
     state = -1; // set out of bounds initially
     direction = true; // default is CW
     step_size = 1;
+    offset_since_epoch = 0;
 
     // init gpio
     gpio_init(IN1);
@@ -36,6 +37,7 @@ SM_28BYJ_48::SM_28BYJ_48(int in1, int in2, int in3, int in4){
  * Base step function. Uses direction, step size set by other step(direction) and warp_speed_mr_sulu(direction)
  */
 void SM_28BYJ_48::step(void){
+    INSTR_SCOPE(INSTR_STEP);
     if(state > 7 || state < 0){ // out of bounds so reset
         if(!direction){
             state = 0;
@@ -44,64 +46,12 @@ void SM_28BYJ_48::step(void){
         }
     }
 
-    //printf("[STEPPER] setting state = %i\n", state);
-    switch(STATE[state]){
-        case 0x08:
-            gpio_put(IN4, 1);
-            gpio_put(IN3, 0);
-            gpio_put(IN2, 0);
-            gpio_put(IN1, 0);
-            break;
-
-        case 0x0C:
-            gpio_put(IN4, 1);
-            gpio_put(IN3, 1);
-            gpio_put(IN2, 0);
-            gpio_put(IN1, 0);
-            break;
-
-        case 0x04:
-            gpio_put(IN4, 0);
-            gpio_put(IN3, 1);
-            gpio_put(IN2, 0);
-            gpio_put(IN1, 0);
-            break;
-
-        case 0x06:
-            gpio_put(IN4, 0);
-            gpio_put(IN3, 1);
-            gpio_put(IN2, 1);
-            gpio_put(IN1, 0);
-            break;
-
-        case 0x02:
-            gpio_put(IN4, 0);
-            gpio_put(IN3, 0);
-            gpio_put(IN2, 1);
-            gpio_put(IN1, 0);
-            break;
-
-        case 0x03:
-            gpio_put(IN4, 0);
-            gpio_put(IN3, 0);
-            gpio_put(IN2, 1);
-            gpio_put(IN1, 1);
-            break;
-
-        case 0x01:
-            gpio_put(IN4, 0);
-            gpio_put(IN3, 0);
-            gpio_put(IN2, 0);
-            gpio_put(IN1, 1);
-            break;
-
-        case 0x09:
-            gpio_put(IN4, 1);
-            gpio_put(IN3, 0);
-            gpio_put(IN2, 0);
-            gpio_put(IN1, 1);
-            break;
-    }
+    // all four coils change in one SIO write, the pattern bits map onto the pins
+    uint8_t coils = STATE[state];
+    uint32_t mask = (1u << IN1) | (1u << IN2) | (1u << IN3) | (1u << IN4);
+    uint32_t value = ((coils & 0x01) ? 1u << IN1 : 0) | ((coils & 0x02) ? 1u << IN2 : 0)
+                   | ((coils & 0x04) ? 1u << IN3 : 0) | ((coils & 0x08) ? 1u << IN4 : 0);
+    gpio_put_masked(mask, value);
 
     state += direction ? -1*step_size : step_size;
     offset_since_epoch += direction ? -1*step_size : step_size; // net distance traveled from home starting pos
@@ -140,3 +90,10 @@ void SM_28BYJ_48::warp_speed_mr_sulu(Direction dir){
 int SM_28BYJ_48::get_state(void){
     return this->state;
 }
+
+/*
+ * Get the net number of steps since the motor object was created, CW steps count down
+ */
+int SM_28BYJ_48::get_offset(void){
+    return this->offset_since_epoch;
+}
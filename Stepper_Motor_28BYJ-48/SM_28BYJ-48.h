@@ -17,9 +17,8 @@ enum Direction {CW=true, CCW=false}; // spindle rotation directions, true when l
  */
 class SM_28BYJ_48 {
     private:
-        int state;      // number of the step that was taken last so we know what step to take next
-        bool direction; // the direction of our next step
-        const uint8_t STATE[8] = {
+        // coil pattern for each phase, bit 3..0 = IN4..IN1. One copy in flash shared by every motor.
+        static constexpr uint8_t STATE[8] = {
                                 0x08,
                                 0x0C,
                                 0x04,
@@ -30,9 +29,11 @@ class SM_28BYJ_48 {
                                 0x09
                              };
 
-        int IN1, IN2, IN3, IN4; // pins used to control the SM
-        int step_size=1;        // set to be either 1 (normal), 2 (fast-ish)
-        int offset_since_epoch; // how many steps and direction since start
+        int32_t offset_since_epoch; // how many steps and direction since start
+        uint8_t IN1, IN2, IN3, IN4; // pins used to control the SM
+        int8_t state;           // number of the step that was taken last so we know what step to take next
+        uint8_t step_size;      // set to be either 1 (normal), 2 (fast-ish)
+        bool direction;         // the direction of our next step
 
     public:
         static const int HALF_REVOLUTION=2048;
@@ -44,5 +45,6 @@ class SM_28BYJ_48 {
         void turtle_speed(Direction);       // set the direction and set speed to 1 (half step)
         void warp_speed_mr_sulu(Direction); // set the direction and set speed to 2 (full step)
         int get_state(void);  // get the state of the motor, ie phase 1-8
+        int get_offset(void); // net steps taken since construction, CCW positive
 };
 #endif
@@ -0,0 +1,81 @@
+/*
+ * Binary telemetry sender
+ */
+#include "telemetry.h"
+#include <pico/stdlib.h>
+#include <string.h>
+
+Telemetry::Telemetry(tlm_write_fn write, void* ctx){
+    this->write = write;
+    this->ctx = ctx;
+    used = 0;
+    sequence = 0;
+    frames_sent = 0;
+    batches_sent = 0;
+}
+
+void Telemetry::send(Tlm_Record* record){
+    uint8_t frame[TLM_MAX_FRAME];
+    record->sequence = sequence++;
+    size_t len = tlm_encode(record, frame);
+
+    if(used + len > TLM_BATCH_BYTES)
+        flush();
+    memcpy(&batch[used], frame, len);
+    used += len;
+    frames_sent++;
+}
+
+void Telemetry::send_sample(uint16_t temp_raw, uint16_t hum_raw){
+    Tlm_Record r;
+    r.type = TLM_SENSOR;
+    r.sensor.time_us = time_us_32();
+    r.sensor.temp_raw = temp_raw;
+    r.sensor.hum_raw = hum_raw;
+    send(&r);
+}
+
+void Telemetry::send_stepper(SM_28BYJ_48* stepper){
+    Tlm_Record r;
+    r.type = TLM_STEPPER;
+    r.stepper.time_us = time_us_32();
+    r.stepper.offset = stepper->get_offset();
+    r.stepper.state = (uint8_t)stepper->get_state();
+    send(&r);
+}
+
+void Telemetry::send_diag(uint8_t device, const Driver_Diag& diag){
+    Diag_Counters c = diag.counters();
+    Tlm_Record r;
+    r.type = TLM_DIAG;
+    r.diag.time_us = time_us_32();
+    r.diag.device = device;
+    r.diag.nacks = c.nacks;
+    r.diag.timeouts = c.timeouts;
+    r.diag.retries = c.retries;
+    r.diag.config_writes = c.config_writes;
+    r.diag.samples = c.samples;
+    r.diag.bad_args = c.bad_args;
+    r.diag.events_logged = c.events_logged;
+    send(&r);
+}
+
+void Telemetry::flush(void){
+    if(used == 0)
+        return;
+    write(batch, used, ctx);
+    used = 0;
+    batches_sent++;
+}
+
+uint16_t Telemetry::buffered(void) const {
+    return used;
+}
+
+uint32_t Telemetry::get_frames_sent(void) const {
+    return frames_sent;
+}
+
+uint32_t Telemetry::get_batches_sent(void) const {
+    return batches_sent;
+}
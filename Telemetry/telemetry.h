@@ -0,0 +1,53 @@
+/*
+ * Binary telemetry sender. Replaces printf("%f") export of readings: records carry the raw sensor
+ *  codes and integer state, so no float formatting is linked in and a sample is 14 bytes on the
+ *  wire instead of a ~25 byte text line. Frames (telemetry_format.h) are collected in a batch
+ *  buffer the size of one full speed USB packet and handed to the output in one write, instead of
+ *  one USB transfer per line.
+ */
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "telemetry_format.h"
+#include "driver_diag.h"
+#include "SM_28BYJ-48.h"
+
+#ifndef TLM_BATCH_BYTES
+#define TLM_BATCH_BYTES 64 /*one USB full speed bulk packet, CDC sends a full packet in one transfer*/
+#endif
+
+static_assert(TLM_BATCH_BYTES >= TLM_MAX_FRAME, "a batch must hold the largest frame");
+
+/*
+ * Output for the batches, called with a whole batch at a time
+ */
+typedef void (*tlm_write_fn)(const uint8_t* data, size_t len, void* ctx);
+
+void tlm_stdio_write(const uint8_t* data, size_t len, void* ctx); // stdio (USB CDC or UART), without CR/LF translation
+
+class Telemetry {
+    private:
+        tlm_write_fn write;
+        void* ctx;
+        uint8_t batch[TLM_BATCH_BYTES];
+        uint16_t used;              // bytes in the batch
+        uint8_t sequence;           // of the next frame
+        uint32_t frames_sent;
+        uint32_t batches_sent;
+
+        void send(Tlm_Record* record);  // frame the record into the batch, flush first if it doesn't fit
+
+    public:
+        Telemetry(tlm_write_fn write=tlm_stdio_write, void* ctx=NULL);
+
+        void send_sample(uint16_t temp_raw, uint16_t hum_raw);  // raw codes, ex. from HDC1080::read_both_raw()
+        void send_stepper(SM_28BYJ_48* stepper);                // position and phase
+        void send_diag(uint8_t device, const Driver_Diag& diag);// snapshot of a driver's counters
+        void flush(void);                                       // write the partial batch now
+
+        uint16_t buffered(void) const;          // bytes waiting for flush()
+        uint32_t get_frames_sent(void) const;
+        uint32_t get_batches_sent(void) const;  // writes to the output
+};
+
+#endif
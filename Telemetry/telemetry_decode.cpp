@@ -0,0 +1,55 @@
+/*
+ * Host tool: decode a telemetry stream and print one line per record.
+ *  usage: telemetry_decode <file or serial port>
+ *      ex. telemetry_decode /dev/ttyACM0, or a capture made with cat /dev/ttyACM0 > capture.bin
+ *  Output lines:
+ *      sensor,time_us,temp_raw,hum_raw,celsius,rh
+ *      stepper,time_us,offset,state
+ *      diag,time_us,device,nacks,timeouts,retries,config_writes,samples,bad_args,events_logged
+ */
+#include "telemetry_decoder.h"
+#include <stdio.h>
+#include <unistd.h>
+
+static void print_record(const Tlm_Record* r, void* ctx){
+    (void)ctx;
+    switch(r->type){
+        case TLM_SENSOR: {
+            // HDC1080 datasheet transfer functions
+            double celsius = r->sensor.temp_raw / 65536.0 * 165.0 - 40.0;
+            double rh = r->sensor.hum_raw / 65536.0 * 100.0;
+            printf("sensor,%u,%u,%u,%.3f,%.3f\n", r->sensor.time_us, r->sensor.temp_raw, r->sensor.hum_raw, celsius, rh);
+            break;
+        }
+        case TLM_STEPPER:
+            printf("stepper,%u,%d,%u\n", r->stepper.time_us, r->stepper.offset, r->stepper.state);
+            break;
+
+        case TLM_DIAG:
+            printf("diag,%u,%u,%u,%u,%u,%u,%u,%u,%u\n", r->diag.time_us, r->diag.device, r->diag.nacks,
+                r->diag.timeouts, r->diag.retries, r->diag.config_writes, r->diag.samples, r->diag.bad_args,
+                r->diag.events_logged);
+            break;
+    }
+    fflush(stdout); // live output when following a serial port
+}
+
+int main(int argc, char** argv){
+    if(argc != 2){
+        fprintf(stderr, "usage: %s <file or serial port>\n", argv[0]);
+        return 2;
+    }
+    int fd = tlm_open_stream(argv[1]);
+    if(fd < 0){
+        fprintf(stderr, "unable to open %s\n", argv[1]);
+        return 1;
+    }
+
+    Tlm_Decoder decoder(print_record, NULL);
+    int result = tlm_read_stream(fd, &decoder, -1);
+    close(fd);
+
+    Tlm_Decoder_Stats s = decoder.get_stats();
+    fprintf(stderr, "%u records, %u damaged frames, %u frames lost\n", s.records, s.bad_frames, s.lost);
+    return result < 0 ? 1 : 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * Host side decoder for the binary telemetry stream
+ */
+#include "telemetry_decoder.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+Tlm_Decoder::Tlm_Decoder(tlm_record_fn fn, void* ctx){
+    this->fn = fn;
+    this->ctx = ctx;
+    reset();
+}
+
+void Tlm_Decoder::reset(void){
+    len = 0;
+    overflow = false;
+    synced = false;
+    have_sequence = false;
+    next_sequence = 0;
+    stats.records = 0;
+    stats.bad_frames = 0;
+    stats.lost = 0;
+}
+
+void Tlm_Decoder::end_frame(void){
+    bool first = !synced;
+    synced = true;
+    if(len == 0 && !overflow)
+        return; // back to back delimiters
+
+    Tlm_Record record;
+    if(overflow || tlm_decode_frame(frame, len, &record) < 0){
+        if(!first)
+            stats.bad_frames++; // else joined the stream mid-frame, expected
+        return;
+    }
+    if(have_sequence)
+        stats.lost += (uint8_t)(record.sequence - next_sequence);
+    have_sequence = true;
+    next_sequence = record.sequence + 1;
+
+    stats.records++;
+    if(fn != NULL)
+        fn(&record, ctx);
+}
+
+void Tlm_Decoder::push(const uint8_t* data, size_t count){
+    for(size_t i = 0; i < count; i++){
+        if(data[i] == 0){
+            end_frame();
+            len = 0;
+            overflow = false;
+        }else if(len < sizeof(frame)){
+            frame[len++] = data[i];
+        }else{
+            overflow = true;
+        }
+    }
+}
+
+Tlm_Decoder_Stats Tlm_Decoder::get_stats(void) const {
+    return stats;
+}
+
+int tlm_open_stream(const char* path){
+    int fd = open(path, O_RDONLY | O_NOCTTY);
+    if(fd < 0)
+        return -1;
+    if(isatty(fd)){
+        // no echo, no line buffering and no CR/LF mapping, the stream is binary
+        struct termios tio;
+        if(tcgetattr(fd, &tio) == 0){
+            cfmakeraw(&tio);
+            tcsetattr(fd, TCSANOW, &tio);
+        }
+    }
+    return fd;
+}
+
+int tlm_read_stream(int fd, Tlm_Decoder* decoder, int timeout_ms){
+    uint8_t buf[4096];
+    int total = 0;
+
+    while(true){
+        struct pollfd p;
+        p.fd = fd;
+        p.events = POLLIN;
+        p.revents = 0;
+        int ready = poll(&p, 1, timeout_ms);
+        if(ready < 0 && errno == EINTR)
+            continue;
+        if(ready < 0)
+            return -1;
+        if(ready == 0)
+            return total; // quiet for timeout_ms
+
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if(n < 0 && errno == EINTR)
+            continue;
+        if(n < 0 && errno == EIO)
+            return total; // other end of the pty/serial port went away
+        if(n < 0)
+            return -1;
+        if(n == 0)
+            return total;
+        decoder->push(buf, (size_t)n);
+        total += (int)n;
+    }
+}
@@ -0,0 +1,44 @@
+/*
+ * Host side decoder for the binary telemetry stream. Bytes can come in any chunking, from a file,
+ *  a pipe or the board's USB serial port (a tty, or a pty in tests). Damaged frames are counted and
+ *  dropped, the decoder resyncs on the next frame delimiter.
+ */
+#ifndef TELEMETRY_DECODER_H
+#define TELEMETRY_DECODER_H
+
+#include "telemetry_format.h"
+
+typedef void (*tlm_record_fn)(const Tlm_Record* record, void* ctx);
+
+struct Tlm_Decoder_Stats {
+    uint32_t records;       // frames decoded and passed on
+    uint32_t bad_frames;    // failed COBS, CRC or length checks, or too long
+    uint32_t lost;          // frames missing according to the sequence numbers
+};
+
+class Tlm_Decoder {
+    private:
+        tlm_record_fn fn;
+        void* ctx;
+        uint8_t frame[TLM_MAX_FRAME];
+        size_t len;             // bytes of the current frame so far
+        bool overflow;          // current frame is too long, drop it at the delimiter
+        bool synced;            // a delimiter has been seen, before that a damaged frame is just a mid-frame start
+        bool have_sequence;
+        uint8_t next_sequence;
+        Tlm_Decoder_Stats stats;
+
+        void end_frame(void);
+
+    public:
+        Tlm_Decoder(tlm_record_fn fn, void* ctx);
+
+        void push(const uint8_t* data, size_t len);    // feed stream bytes, calls fn for each complete record
+        Tlm_Decoder_Stats get_stats(void) const;
+        void reset(void);                               // forget partial frames, sequence and counters
+};
+
+int tlm_open_stream(const char* path);      // open a file or serial port for reading, ttys are put in raw mode, -1 on error
+int tlm_read_stream(int fd, Tlm_Decoder* decoder, int timeout_ms); // feed everything until end of file, hangup or timeout_ms without data (< 0 waits forever), returns bytes read or -1
+
+#endif
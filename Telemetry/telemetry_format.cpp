@@ -0,0 +1,181 @@
+/*
+ * Wire format of the binary telemetry stream, see telemetry_format.h
+ */
+#include "telemetry_format.h"
+
+#define TLM_SENSOR_LEN 8
+#define TLM_STEPPER_LEN 9
+#define TLM_DIAG_LEN 33
+
+/*
+ * CRC-16/CCITT-FALSE (poly 0x1021, MSB first) with a 16 entry table
+ */
+uint16_t tlm_crc16(uint16_t crc, const uint8_t* data, size_t len){
+    static const uint16_t TABLE[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+    for(size_t i = 0; i < len; i++){
+        crc = (uint16_t)((crc << 4) ^ TABLE[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ TABLE[(crc >> 12) ^ (data[i] & 0x0F)]);
+    }
+    return crc;
+}
+
+/*
+ * Each run of up to 254 non-zero bytes is prefixed with its length + 1, the zero that ends the
+ *  run is implied
+ */
+size_t cobs_encode(const uint8_t* src, size_t len, uint8_t* dst){
+    size_t code_pos = 0;
+    size_t out = 1;
+    uint8_t code = 1;
+
+    for(size_t i = 0; i < len; i++){
+        if(src[i] == 0){
+            dst[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+            continue;
+        }
+        dst[out++] = src[i];
+        if(++code == 0xFF){ // longest run, no implied zero
+            dst[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        }
+    }
+    dst[code_pos] = code;
+    return out;
+}
+
+int cobs_decode(const uint8_t* src, size_t len, uint8_t* dst){
+    size_t in = 0;
+    size_t out = 0;
+
+    while(in < len){
+        uint8_t code = src[in++];
+        if(code == 0 || in + code - 1 > len)
+            return -1;
+        for(int i = 1; i < code; i++){
+            if(src[in] == 0)
+                return -1;
+            dst[out++] = src[in++];
+        }
+        if(code < 0xFF && in < len)
+            dst[out++] = 0;
+    }
+    return (int)out;
+}
+
+static uint8_t* put_u16(uint8_t* p, uint16_t v){
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static uint8_t* put_u32(uint8_t* p, uint32_t v){
+    p = put_u16(p, (uint16_t)v);
+    return put_u16(p, (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t* p){
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p){
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+size_t tlm_encode(const Tlm_Record* record, uint8_t* dst){
+    uint8_t raw[TLM_MAX_RAW];
+    uint8_t* p = raw;
+    *p++ = record->type;
+    *p++ = record->sequence;
+
+    switch(record->type){
+        case TLM_SENSOR:
+            p = put_u32(p, record->sensor.time_us);
+            p = put_u16(p, record->sensor.temp_raw);
+            p = put_u16(p, record->sensor.hum_raw);
+            break;
+
+        case TLM_STEPPER:
+            p = put_u32(p, record->stepper.time_us);
+            p = put_u32(p, (uint32_t)record->stepper.offset);
+            *p++ = record->stepper.state;
+            break;
+
+        case TLM_DIAG:
+            p = put_u32(p, record->diag.time_us);
+            *p++ = record->diag.device;
+            p = put_u32(p, record->diag.nacks);
+            p = put_u32(p, record->diag.timeouts);
+            p = put_u32(p, record->diag.retries);
+            p = put_u32(p, record->diag.config_writes);
+            p = put_u32(p, record->diag.samples);
+            p = put_u32(p, record->diag.bad_args);
+            p = put_u32(p, record->diag.events_logged);
+            break;
+
+        default:
+            return 0;
+    }
+    p = put_u16(p, tlm_crc16(0xFFFF, raw, p - raw));
+
+    size_t n = cobs_encode(raw, p - raw, dst);
+    dst[n++] = 0;
+    return n;
+}
+
+int tlm_decode_frame(const uint8_t* src, size_t len, Tlm_Record* record){
+    uint8_t raw[TLM_MAX_FRAME];
+    if(len > TLM_MAX_FRAME - 1)
+        return -1;
+    int n = cobs_decode(src, len, raw);
+    if(n < 4)
+        return -1;
+    if(tlm_crc16(0xFFFF, raw, n - 2) != get_u16(&raw[n - 2]))
+        return -1;
+
+    const uint8_t* p = raw + 2;
+    size_t payload_len = n - 4;
+    record->type = raw[0];
+    record->sequence = raw[1];
+
+    switch(record->type){
+        case TLM_SENSOR:
+            if(payload_len != TLM_SENSOR_LEN)
+                return -1;
+            record->sensor.time_us = get_u32(p);
+            record->sensor.temp_raw = get_u16(p + 4);
+            record->sensor.hum_raw = get_u16(p + 6);
+            break;
+
+        case TLM_STEPPER:
+            if(payload_len != TLM_STEPPER_LEN)
+                return -1;
+            record->stepper.time_us = get_u32(p);
+            record->stepper.offset = (int32_t)get_u32(p + 4);
+            record->stepper.state = p[8];
+            break;
+
+        case TLM_DIAG:
+            if(payload_len != TLM_DIAG_LEN)
+                return -1;
+            record->diag.time_us = get_u32(p);
+            record->diag.device = p[4];
+            record->diag.nacks = get_u32(p + 5);
+            record->diag.timeouts = get_u32(p + 9);
+            record->diag.retries = get_u32(p + 13);
+            record->diag.config_writes = get_u32(p + 17);
+            record->diag.samples = get_u32(p + 21);
+            record->diag.bad_args = get_u32(p + 25);
+            record->diag.events_logged = get_u32(p + 29);
+            break;
+
+        default:
+            return -1; // newer firmware, unknown record
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * Wire format of the binary telemetry stream, shared by the sender on the board and the host decoder.
+ *  No SDK dependencies so it builds anywhere.
+ *
+ *  Every record is one frame:
+ *      COBS( type | sequence | payload | CRC-16 ) 0x00
+ *  COBS removes every 0x00 from the frame so 0x00 only ever marks a frame end, a reader that joins
+ *  the stream at any point (or loses bytes) resyncs at the next 0x00. Fields are little endian.
+ *  The sequence counts frames modulo 256 so the reader can tell how many frames it lost.
+ *  The CRC is CRC-16/CCITT-FALSE over type, sequence and payload.
+ */
+#ifndef TELEMETRY_FORMAT_H
+#define TELEMETRY_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define TLM_MAX_PAYLOAD 33                      /*largest payload, TLM_DIAG*/
+#define TLM_MAX_RAW (2 + TLM_MAX_PAYLOAD + 2)   /*type, sequence, payload, CRC*/
+#define TLM_MAX_FRAME (TLM_MAX_RAW + 2)         /*+1 COBS overhead (frames are < 254 bytes), +1 delimiter*/
+
+enum Tlm_Type {TLM_SENSOR=1,    /*raw HDC1080 codes*/
+            TLM_STEPPER=2,      /*stepper position and phase*/
+            TLM_DIAG=3};        /*driver diagnostics counters*/
+
+struct Tlm_Sensor {
+    uint32_t time_us;
+    uint16_t temp_raw;  // convert with HDC1080::raw_to_float()
+    uint16_t hum_raw;
+};
+
+struct Tlm_Stepper {
+    uint32_t time_us;
+    int32_t offset;     // SM_28BYJ_48::get_offset(), net steps since start
+    uint8_t state;      // SM_28BYJ_48::get_state()
+};
+
+/*
+ * Same counters as Diag_Counters (driver_diag.h)
+ */
+struct Tlm_Diag {
+    uint32_t time_us;
+    uint8_t device;     // application chosen tag, ex. 0 for the first HDC1080
+    uint32_t nacks;
+    uint32_t timeouts;
+    uint32_t retries;
+    uint32_t config_writes;
+    uint32_t samples;
+    uint32_t bad_args;
+    uint32_t events_logged;
+};
+
+struct Tlm_Record {
+    uint8_t type;       // Tlm_Type
+    uint8_t sequence;
+    union {
+        Tlm_Sensor sensor;
+        Tlm_Stepper stepper;
+        Tlm_Diag diag;
+    };
+};
+
+uint16_t tlm_crc16(uint16_t crc, const uint8_t* data, size_t len); // start with crc = 0xFFFF
+
+size_t cobs_encode(const uint8_t* src, size_t len, uint8_t* dst);   // returns bytes written, at most len + len / 254 + 1
+int cobs_decode(const uint8_t* src, size_t len, uint8_t* dst);      // returns bytes written, -1 if src is not valid COBS
+
+size_t tlm_encode(const Tlm_Record* record, uint8_t* dst);              // whole frame incl. delimiter into TLM_MAX_FRAME bytes, 0 on unknown type
+int tlm_decode_frame(const uint8_t* src, size_t len, Tlm_Record* record); // one frame without the delimiter, -1 if damaged
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * Default telemetry sink. In its own file so stdio is only linked in when this sink is used.
+ */
+#include "telemetry.h"
+#include <pico/stdlib.h>
+#if PICO_ON_DEVICE && LIB_PICO_STDIO_USB
+#include <pico/stdio_usb.h>
+#endif
+#if PICO_ON_DEVICE && LIB_PICO_STDIO_UART
+#include <pico/stdio_uart.h>
+#endif
+
+/*
+ * CR/LF translation would corrupt binary frames, so it is turned off for the stdio drivers before
+ *  the first batch. This also affects printf() text on the same port, which should not be mixed
+ *  with telemetry anyway.
+ */
+static void tlm_stdio_binary(void){
+#if PICO_ON_DEVICE
+    static bool binary;
+    if(binary)
+        return;
+#if LIB_PICO_STDIO_USB
+    stdio_set_translate_crlf(&stdio_usb, false);
+#endif
+#if LIB_PICO_STDIO_UART
+    stdio_set_translate_crlf(&stdio_uart, false);
+#endif
+    binary = true;
+#endif
+}
+
+/*
+ * The whole batch goes to the stdio drivers in one write and is flushed once, instead of one
+ *  putchar_raw() per byte, each of which flushes the USB endpoint.
+ */
+void tlm_stdio_write(const uint8_t* data, size_t len, void* ctx){
+    (void)ctx;
+    tlm_stdio_binary();
+    fwrite(data, 1, len, stdout);
+    fflush(stdout);
+    stdio_flush();
+}
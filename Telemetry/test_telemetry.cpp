@@ -0,0 +1,205 @@
+/*
+ * Tests for the telemetry framing, sender batching and host decoder, including a pass through a
+ *  pseudo terminal like the board's USB serial port, and the default stdio sink.
+ */
+#include "sim_test.h"
+#include "sim.h"
+#include "telemetry.h"
+#include "telemetry_decoder.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+struct Capture {
+    std::vector<uint8_t> bytes;
+    std::vector<size_t> writes; // size of each write
+};
+
+static void capture_write(const uint8_t* data, size_t len, void* ctx){
+    Capture* c = (Capture*)ctx;
+    c->bytes.insert(c->bytes.end(), data, data + len);
+    c->writes.push_back(len);
+}
+
+static void collect(const Tlm_Record* r, void* ctx){
+    ((std::vector<Tlm_Record>*)ctx)->push_back(*r);
+}
+
+static void test_crc_and_cobs(){
+    CHECK_EQ(tlm_crc16(0xFFFF, (const uint8_t*)"123456789", 9), 0x29B1); // CRC-16/CCITT-FALSE check value
+
+    uint8_t src[600], enc[610], dec[610];
+    for(int i = 0; i < 600; i++)
+        src[i] = (uint8_t)(i < 300 ? i % 7 : 1 + i % 200); // zeros early, a run longer than 254 later
+    size_t n = cobs_encode(src, sizeof(src), enc);
+    CHECK(n <= sizeof(src) + sizeof(src) / 254 + 1);
+    CHECK(memchr(enc, 0, n) == NULL);
+    CHECK_EQ(cobs_decode(enc, n, dec), 600);
+    CHECK(memcmp(src, dec, sizeof(src)) == 0);
+
+    uint8_t bad[] = {0x05, 0x01, 0x02};     // claims 4 data bytes, has 2
+    CHECK_EQ(cobs_decode(bad, sizeof(bad), dec), -1);
+}
+
+static void test_records_roundtrip_in_batches(){
+    sim_reset();
+    Capture cap;
+    Telemetry tlm(capture_write, &cap);
+
+    SM_28BYJ_48 stepper(0, 1, 6, 13);
+    for(int i = 0; i < 10; i++)
+        stepper.step(CCW);
+    Driver_Diag diag;
+    diag.record(DIAG_NACK, 0x00, -2);
+    diag.increment(DIAG_SAMPLE);
+
+    for(int i = 0; i < 20; i++)
+        tlm.send_sample((uint16_t)(25000 + i), (uint16_t)(0 + i)); // zero bytes in the payload
+    tlm.send_stepper(&stepper);
+    tlm.send_diag(3, diag);
+    tlm.flush();
+
+    bool batches_fit = true;
+    for(size_t w : cap.writes)
+        batches_fit = batches_fit && w <= TLM_BATCH_BYTES;
+    CHECK(batches_fit);
+    CHECK_EQ(tlm.get_frames_sent(), 22);
+    CHECK_EQ(cap.writes.size(), tlm.get_batches_sent());
+    CHECK(cap.writes.size() <= 8);          // 14 byte sample frames, 4 per batch
+
+    std::vector<Tlm_Record> out;
+    Tlm_Decoder dec(collect, &out);
+    dec.push(cap.bytes.data(), cap.bytes.size());
+    CHECK_EQ(out.size(), 22);
+    CHECK_EQ(dec.get_stats().bad_frames, 0);
+    CHECK_EQ(dec.get_stats().lost, 0);
+    if(out.size() != 22)
+        return;
+
+    CHECK_EQ(out[0].type, TLM_SENSOR);
+    CHECK_EQ(out[19].sensor.temp_raw, 25019);
+    CHECK_EQ(out[19].sensor.hum_raw, 19);
+    CHECK_EQ(out[20].type, TLM_STEPPER);
+    CHECK_EQ(out[20].stepper.offset, 10);
+    CHECK_EQ(out[20].stepper.state, stepper.get_state());
+    CHECK_EQ(out[21].type, TLM_DIAG);
+    CHECK_EQ(out[21].diag.device, 3);
+    CHECK_EQ(out[21].diag.nacks, 1);
+    CHECK_EQ(out[21].diag.samples, 1);
+}
+
+static void test_damage_and_resync(){
+    Capture cap;
+    Telemetry tlm(capture_write, &cap);
+    for(int i = 0; i < 6; i++)
+        tlm.send_sample((uint16_t)(100 + i), (uint16_t)(200 + i));
+    tlm.flush();
+
+    // flip a bit in the second frame, drop the fourth frame entirely, split the stream oddly
+    std::vector<uint8_t> s = cap.bytes;
+    s[14 + 5] ^= 0x10;
+    s.erase(s.begin() + 3 * 14, s.begin() + 4 * 14);
+
+    std::vector<Tlm_Record> out;
+    Tlm_Decoder dec(collect, &out);
+    for(size_t i = 0; i < s.size(); i += 5)
+        dec.push(&s[i], s.size() - i < 5 ? s.size() - i : 5);
+
+    CHECK_EQ(out.size(), 4);
+    CHECK_EQ(dec.get_stats().bad_frames, 1);
+    CHECK_EQ(dec.get_stats().lost, 2);      // the damaged frame and the missing one
+
+    // a reader that starts in the middle of a frame drops it quietly
+    out.clear();
+    dec.reset();
+    dec.push(&cap.bytes[7], cap.bytes.size() - 7);
+    CHECK_EQ(out.size(), 5);
+    CHECK_EQ(dec.get_stats().bad_frames, 0);
+}
+
+static void pty_write(const uint8_t* data, size_t len, void* ctx){
+    int fd = *(int*)ctx;
+    while(len > 0){
+        ssize_t n = write(fd, data, len);
+        if(n <= 0)
+            return;
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+static void test_pty_stream(){
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if(master < 0 || grantpt(master) < 0 || unlockpt(master) < 0){
+        printf("no pty available, skipped\n");
+        return;
+    }
+    int slave = tlm_open_stream(ptsname(master)); // raw mode, 0x0A and 0x0D pass unchanged
+    CHECK(slave >= 0);
+
+    sim_reset();
+    Telemetry tlm(pty_write, &master);
+    for(int i = 0; i < 200; i++)
+        tlm.send_sample((uint16_t)(0x0A0D + i), (uint16_t)(0x0D0A - i));
+    tlm.flush();
+
+    std::vector<Tlm_Record> out;
+    Tlm_Decoder dec(collect, &out);
+    CHECK(tlm_read_stream(slave, &dec, 100) > 0);
+    CHECK_EQ(out.size(), 200);
+    CHECK_EQ(dec.get_stats().bad_frames, 0);
+    if(out.size() == 200)
+        CHECK_EQ(out[199].sensor.hum_raw, 0x0D0A - 199);
+
+    close(slave);
+    close(master);
+}
+
+/*
+ * The default sink, with stdout pointed at a file
+ */
+static void test_stdio_sink(){
+    FILE* file = tmpfile();
+    CHECK(file != NULL);
+    if(file == NULL)
+        return;
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    dup2(fileno(file), STDOUT_FILENO);
+
+    sim_reset();
+    Telemetry tlm;
+    for(int i = 0; i < 100; i++)
+        tlm.send_sample((uint16_t)(0x0A0D + i), 0x0A0A);
+    tlm.flush();
+    uint32_t batches = tlm.get_batches_sent();
+
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+
+    std::vector<uint8_t> bytes;
+    rewind(file);
+    for(int c = fgetc(file); c != EOF; c = fgetc(file))
+        bytes.push_back((uint8_t)c);
+    fclose(file);
+
+    std::vector<Tlm_Record> out;
+    Tlm_Decoder dec(collect, &out);
+    dec.push(bytes.data(), bytes.size());
+    CHECK(batches > 1);
+    CHECK_EQ(out.size(), 100);
+    CHECK_EQ(dec.get_stats().bad_frames, 0);
+    if(out.size() == 100)
+        CHECK_EQ(out[99].sensor.temp_raw, 0x0A0D + 99);
+}
+
+int main(){
+    RUN_TEST(test_crc_and_cobs);
+    RUN_TEST(test_records_roundtrip_in_batches);
+    RUN_TEST(test_damage_and_resync);
+    RUN_TEST(test_pty_stream);
+    RUN_TEST(test_stdio_sink);
+    return TEST_RESULT();
+}
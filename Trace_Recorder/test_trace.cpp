@@ -0,0 +1,238 @@
+/*
+ * Tests for the trace recorder, fed by the simulated board. Timing properties of the drivers are
+ *  asserted on the trace the same way they would be read off a logic analyzer.
+ *  usage: test_trace [vcd output path]
+ */
+#include "sim_test.h"
+#include "sim.h"
+#include "sim_hdc1080.h"
+#include "trace.h"
+#include "trace_check.h"
+#include "trace_sim.h"
+#include "trace_vcd.h"
+#include "SM_28BYJ-48.h"
+#include "vandaluino_7segment.h"
+#include "hdc1080.h"
+#include <pico/stdlib.h>
+#include <string.h>
+#include <string>
+
+#define STEPPER_PINS 0x0F   /*IN1-IN4 on GPIO 0-3*/
+#define STEP_INTERVAL_US 2000
+#define DIGIT_ON_US 5000
+#define TIMER_RESOLUTION_NS 1000    /*sleep_us() counts from the current whole microsecond*/
+
+static Trace_Event storage[512];
+static const char* vcd_path;
+
+static void test_ring(){
+    Trace_Event small[4];
+    Trace_Buffer trace(small, 4, 1000000, 0x3);
+
+    trace.record_gpio(0, 0x0);
+    trace.record_gpio(10, 0x4);     // untraced pin, dropped
+    trace.record_gpio(20, 0x1);
+    trace.record_gpio(30, 0x1);     // no change, dropped
+    CHECK_EQ(trace.size(), 2);
+    CHECK_EQ(trace.at(1).time, 20);
+    CHECK_EQ(trace.at(1).value, 0x1);
+
+    for(uint32_t t = 40; t < 80; t += 10)
+        trace.record_gpio(t, (t / 10) & 1 ? 0x2 : 0x3);
+    CHECK_EQ(trace.size(), 4);
+    CHECK_EQ(trace.get_overwritten(), 2);
+    CHECK_EQ(trace.at(0).time, 40);     // oldest kept
+    CHECK_EQ(trace.at(3).time, 70);
+
+    trace.clear();
+    trace.record_gpio(100, 0x2);        // same levels as before clear, still stored as the new baseline
+    CHECK_EQ(trace.size(), 1);
+    CHECK_EQ(trace.ticks_to_ns(3), 3000);
+}
+
+/*
+ * Times wrap at 2^32 ticks, measurements use the differences
+ */
+static void test_wrap(){
+    Trace_Event small[8];
+    Trace_Buffer trace(small, 8, 1000000, 0x1);
+    trace.record_gpio(0xFFFFFF00u, 0);
+    trace.record_gpio(0xFFFFFFF0u, 1);
+    trace.record_gpio(0x00000010u, 0);
+    trace.record_gpio(0x00000110u, 1);
+
+    CHECK_EQ(trace_count_changes(trace, 0x1), 3);
+    CHECK_EQ(trace_min_interval_ns(trace, 0x1), 32000);    // 0xFFFFFFF0 -> 0x10
+    Trace_Pulses high;
+    CHECK_EQ(trace_pulses(trace, 0, true, &high), 1);
+    CHECK_EQ(high.min_ns, 32000);
+    CHECK_EQ(trace_pulses(trace, 5, true, &high), -1);    // not traced
+}
+
+static void test_stepper_interval(){
+    sim_reset();
+    SM_28BYJ_48 motor(0, 1, 2, 3);
+    Trace_Buffer trace(storage, 512, TRACE_SIM_TICK_HZ, STEPPER_PINS);
+    trace_sim_attach(&trace);
+
+    for(int i = 0; i < 100; i++){
+        motor.step(CW);
+        sleep_us(STEP_INTERVAL_US);
+    }
+    CHECK_EQ(trace_count_changes(trace, STEPPER_PINS), 100);   // all four coils change in one write
+    int64_t min_ns = trace_min_interval_ns(trace, STEPPER_PINS);
+    CHECK(min_ns > STEP_INTERVAL_US * 1000 - TIMER_RESOLUTION_NS);
+    CHECK(min_ns < STEP_INTERVAL_US * 1000 + TIMER_RESOLUTION_NS);
+
+    // a burst without the delay breaks the limit and the trace shows it
+    motor.step(CW);
+    motor.step(CW);
+    CHECK(trace_min_interval_ns(trace, STEPPER_PINS) < STEP_INTERVAL_US * 1000 - TIMER_RESOLUTION_NS);
+    trace_sim_detach();
+}
+
+/*
+ * Multiplexed display: each digit is lit while its common cathode is low
+ */
+static void test_digit_on_time(){
+    sim_reset();
+    init_7_segment();
+    Trace_Buffer trace(storage, 512, TRACE_SIM_TICK_HZ, ALL_SEGMENTS | CCX);
+    trace_sim_attach(&trace);
+
+    for(int i = 0; i < 20; i++){
+        show_on_right(SEGMENT_NUM[i % 10]);
+        sleep_us(DIGIT_ON_US);
+        show_on_left(SEGMENT_HEX[15 - i % 16]);
+        sleep_us(DIGIT_ON_US);
+    }
+    gpio_set_mask(CCX);     // blank
+
+    Trace_Pulses right, left;
+    CHECK_EQ(trace_pulses(trace, CC2, false, &right), 20);
+    CHECK_EQ(trace_pulses(trace, CC1, false, &left), 20);
+    CHECK(right.min_ns > DIGIT_ON_US * 1000 - TIMER_RESOLUTION_NS);
+    CHECK(right.max_ns < DIGIT_ON_US * 1000 + TIMER_RESOLUTION_NS);
+    CHECK(left.min_ns > DIGIT_ON_US * 1000 - TIMER_RESOLUTION_NS);
+    CHECK(left.max_ns < DIGIT_ON_US * 1000 + TIMER_RESOLUTION_NS);
+    // both digits lit the same share of the time, no visible brightness difference
+    int64_t imbalance = (int64_t)right.total_ns - (int64_t)left.total_ns;
+    CHECK(imbalance < 20 * TIMER_RESOLUTION_NS && imbalance > -20 * TIMER_RESOLUTION_NS);
+
+    // cathodes never low together, the segments would show on both digits
+    bool overlap = false;
+    for(uint32_t i = 0; i < trace.size(); i++){
+        if(trace.at(i).kind == TRACE_GPIO && (trace.at(i).value & CCX) == 0)
+            overlap = true;
+    }
+    CHECK(!overlap);
+    trace_sim_detach();
+}
+
+static void test_i2c(){
+    sim_reset();
+    Sim_HDC1080 model;
+    sim_i2c_attach(i2c0, Sim_HDC1080::ADDRESS, &model);
+    model.set_environment(21.0, 40.0);
+    HDC1080 hdc(i2c0);
+    Trace_Buffer trace(storage, 512, TRACE_SIM_TICK_HZ, 0);
+    trace_sim_attach(&trace);
+
+    hdc.celsius();
+    sim_i2c_detach(i2c0, Sim_HDC1080::ADDRESS);
+    hdc.celsius();      // nobody answers
+
+    // temperature pointer write, then the 2 byte result read after the conversion time
+    int write_at = -1;
+    for(uint32_t i = 0; i < trace.size(); i++){
+        const Trace_Event& e = trace.at(i);
+        if(write_at < 0 && e.kind == TRACE_I2C_WRITE && e.data == 0x00 && e.result == 1)
+            write_at = (int)i;
+    }
+    CHECK(write_at >= 0);
+    if(write_at >= 0 && (uint32_t)write_at + 1 < trace.size()){
+        const Trace_Event& w = trace.at(write_at);
+        const Trace_Event& r = trace.at(write_at + 1);
+        CHECK_EQ(r.kind, TRACE_I2C_READ);
+        CHECK_EQ(r.addr, Sim_HDC1080::ADDRESS);
+        CHECK_EQ(r.result, 2);
+        CHECK(trace.ticks_to_ns(r.time - w.time - w.value) >= SIM_HDC_TEMP_14_US * 1000ull);
+    }
+
+    Trace_I2C_Summary s;
+    trace_i2c_summary(trace, Sim_HDC1080::ADDRESS, &s);
+    CHECK(s.transfers >= 4);
+    CHECK(s.failed >= 1);
+    CHECK(s.busy_ns > 0);
+    CHECK(s.min_gap_ns >= 0);
+    trace_sim_detach();
+}
+
+/*
+ * Stepper and display traced together and written to a VCD
+ */
+static void test_vcd(){
+    sim_reset();
+    Sim_HDC1080 model;
+    sim_i2c_attach(i2c0, Sim_HDC1080::ADDRESS, &model);
+    HDC1080 hdc(i2c0);
+    init_7_segment();
+    SM_28BYJ_48 motor(0, 1, 2, 3);
+    Trace_Buffer trace(storage, 512, TRACE_SIM_TICK_HZ, STEPPER_PINS | CCX);
+    trace_sim_attach(&trace);
+
+    for(int i = 0; i < 8; i++){
+        motor.step(CCW);
+        show_on_right(SEGMENT_NUM[i]);
+        sleep_us(STEP_INTERVAL_US);
+    }
+    hdc.celsius();
+
+    const Trace_Signal names[] = {{0, "IN1"}, {1, "IN2"}, {2, "IN3"}, {3, "IN4"}, {CC1, "CC1"}, {CC2, "CC2"}};
+    FILE* f = fopen(vcd_path, "w+");
+    CHECK(f != NULL);
+    if(f == NULL)
+        return;
+    CHECK_EQ(trace_write_vcd(trace, f, names, 6), 0);
+
+    rewind(f);
+    std::string vcd;
+    char line[256];
+    while(fgets(line, sizeof(line), f) != NULL)
+        vcd += line;
+    fclose(f);
+
+    CHECK(vcd.find("$timescale 1ns $end") != std::string::npos);
+    CHECK(vcd.find("$var wire 1 ! IN1 $end") != std::string::npos);
+    CHECK(vcd.find(" CC2 $end") != std::string::npos);
+    CHECK(vcd.find("$var wire 7") != std::string::npos);    // i2c_addr
+    CHECK(vcd.find("b1000000 ") != std::string::npos);      // 0x40 on the bus
+    CHECK(vcd.find("$enddefinitions $end") != std::string::npos);
+
+    // timestamps never go backwards
+    uint64_t last = 0;
+    bool ordered = true;
+    int stamps = 0;
+    for(size_t pos = vcd.find("\n#"); pos != std::string::npos; pos = vcd.find("\n#", pos + 1)){
+        uint64_t t = strtoull(vcd.c_str() + pos + 2, NULL, 10);
+        if(t < last)
+            ordered = false;
+        last = t;
+        stamps++;
+    }
+    CHECK(ordered);
+    CHECK(stamps > 16);
+    trace_sim_detach();
+}
+
+int main(int argc, char** argv){
+    vcd_path = argc > 1 ? argv[1] : "test_trace.vcd";
+
+    RUN_TEST(test_ring);
+    RUN_TEST(test_wrap);
+    RUN_TEST(test_stepper_interval);
+    RUN_TEST(test_digit_on_time);
+    RUN_TEST(test_i2c);
+    RUN_TEST(test_vcd);
+    return TEST_RESULT();
+}
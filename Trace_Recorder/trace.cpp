@@ -0,0 +1,83 @@
+/*
+ * GPIO/I2C trace ring
+ */
+#include "trace.h"
+
+Trace_Buffer::Trace_Buffer(Trace_Event* storage, uint32_t capacity, uint32_t tick_hz, uint32_t pin_mask){
+    events = storage;
+    this->capacity = capacity;
+    this->tick_hz = tick_hz;
+    this->pin_mask = pin_mask;
+    clear();
+}
+
+void Trace_Buffer::push(const Trace_Event& event){
+    if(capacity == 0)
+        return;
+    events[head] = event;
+    head = (head + 1) % capacity;
+    if(count < capacity)
+        count++;
+    else
+        overwritten++;
+}
+
+void Trace_Buffer::record_gpio(uint32_t time, uint32_t outputs){
+    outputs &= pin_mask;
+    if(have_levels && outputs == levels)
+        return;
+    have_levels = true;
+    levels = outputs;
+
+    Trace_Event e = Trace_Event();
+    e.time = time;
+    e.value = outputs;
+    e.kind = TRACE_GPIO;
+    push(e);
+}
+
+void Trace_Buffer::record_i2c(uint32_t time, uint32_t duration, uint8_t addr, bool read, const uint8_t* data, int result){
+    Trace_Event e = Trace_Event();
+    e.time = time;
+    e.value = duration;
+    e.kind = read ? TRACE_I2C_READ : TRACE_I2C_WRITE;
+    e.addr = addr;
+    e.data = (result > 0 && data != NULL) ? data[0] : 0;
+    e.result = (int8_t)(result > 127 ? 127 : result);
+    push(e);
+}
+
+void Trace_Buffer::clear(void){
+    head = 0;
+    count = 0;
+    overwritten = 0;
+    levels = 0;
+    have_levels = false;
+}
+
+uint32_t Trace_Buffer::size(void) const {
+    return count;
+}
+
+const Trace_Event& Trace_Buffer::at(uint32_t i) const {
+    return events[(head + capacity - count + i) % capacity];
+}
+
+uint32_t Trace_Buffer::get_overwritten(void) const {
+    return overwritten;
+}
+
+uint32_t Trace_Buffer::get_tick_hz(void) const {
+    return tick_hz;
+}
+
+uint32_t Trace_Buffer::get_pin_mask(void) const {
+    return pin_mask;
+}
+
+/*
+ * Split so ticks * 1e9 can't overflow for long traces
+ */
+uint64_t Trace_Buffer::ticks_to_ns(uint64_t ticks) const {
+    return ticks / tick_hz * 1000000000ull + ticks % tick_hz * 1000000000ull / tick_hz;
+}
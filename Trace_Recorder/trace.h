@@ -0,0 +1,66 @@
+/*
+ * Logic analyzer style trace of GPIO levels and I2C transfers, kept in a ring in RAM.
+ *  Only changes of the traced pins are stored, so a stepper step or a display refresh costs one
+ *  event instead of one per sample. When the ring is full the oldest events are overwritten.
+ *
+ *  Feeds: trace_sim.h records the simulated board on the host, trace_pio.h samples the pins with
+ *  PIO + DMA on the board. trace_vcd.h exports a trace for GTKWave and trace_check.h measures
+ *  timing on it (minimum step interval, digit on-time, ...).
+ *
+ *  Times are ticks of the feed's clock (clk_sys cycles on the host, samples on the board) in 32 bits.
+ *  They wrap, readers only use the difference between consecutive events, so a trace stays valid
+ *  as long as no two neighboring events are more than 2^32 ticks apart (34s at 125MHz).
+ *
+ *  One writer: record from one core and not from an interrupt while the other side records.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+enum Trace_Kind {TRACE_GPIO=0,      /*traced pins changed, value = new levels*/
+                TRACE_I2C_WRITE=1,  /*value = ticks the bus was busy, data = first byte (register pointer)*/
+                TRACE_I2C_READ=2};  /*value = ticks the bus was busy, data = first byte read*/
+
+struct Trace_Event {
+    uint32_t time;      // ticks, wraps
+    uint32_t value;     // depends on kind
+    uint8_t kind;       // Trace_Kind
+    uint8_t addr;       // I2C: 7 bit device address
+    uint8_t data;       // I2C: first byte on the wire after the address
+    int8_t result;      // I2C: bytes transferred (127 max) or PICO_ERROR_* if it failed
+};
+
+static_assert(sizeof(Trace_Event) == 12, "keep events compact, the ring lives in RAM");
+
+class Trace_Buffer {
+    private:
+        Trace_Event* events;    // caller supplied storage
+        uint32_t capacity;
+        uint32_t head;          // slot the next event goes to
+        uint32_t count;         // events stored, at most capacity
+        uint32_t overwritten;   // events lost to wrapping since clear()
+        uint32_t tick_hz;
+        uint32_t pin_mask;      // pins traced, others are ignored
+        uint32_t levels;        // last recorded levels of the traced pins
+        bool have_levels;       // false until the first GPIO event, which is always stored
+
+        void push(const Trace_Event& event);
+
+    public:
+        Trace_Buffer(Trace_Event* storage, uint32_t capacity, uint32_t tick_hz, uint32_t pin_mask);
+
+        void record_gpio(uint32_t time, uint32_t outputs);  // stores an event if a traced pin changed
+        void record_i2c(uint32_t time, uint32_t duration, uint8_t addr, bool read, const uint8_t* data, int result);
+        void clear(void);                           // drop all events, the next GPIO record is the new baseline
+
+        uint32_t size(void) const;                  // events stored
+        const Trace_Event& at(uint32_t i) const;    // 0 is the oldest stored event
+        uint32_t get_overwritten(void) const;       // > 0 means the start of the trace was lost
+        uint32_t get_tick_hz(void) const;
+        uint32_t get_pin_mask(void) const;
+        uint64_t ticks_to_ns(uint64_t ticks) const;
+};
+
+#endif
@@ -0,0 +1,139 @@
+/*
+ * Timing measurements on a trace
+ */
+#include "trace_check.h"
+
+/*
+ * Walks the events oldest first with times unwrapped to 64 bits, relative to the first event
+ */
+class Trace_Walk {
+    private:
+        const Trace_Buffer& trace;
+        uint32_t next;
+        uint32_t last_time;
+        uint64_t now;
+
+    public:
+        Trace_Walk(const Trace_Buffer& trace) : trace(trace){
+            next = 0;
+            last_time = trace.size() > 0 ? trace.at(0).time : 0;
+            now = 0;
+        }
+
+        const Trace_Event* step(void){
+            if(next >= trace.size())
+                return NULL;
+            const Trace_Event& e = trace.at(next++);
+            now += (uint32_t)(e.time - last_time);
+            last_time = e.time;
+            return &e;
+        }
+
+        uint64_t time(void) const {
+            return now;
+        }
+};
+
+int trace_count_changes(const Trace_Buffer& trace, uint32_t mask){
+    Trace_Walk walk(trace);
+    const Trace_Event* e;
+    bool have_levels = false;
+    uint32_t levels = 0;
+    int changes = 0;
+
+    while((e = walk.step()) != NULL){
+        if(e->kind != TRACE_GPIO)
+            continue;
+        if(have_levels && ((e->value ^ levels) & mask))
+            changes++;
+        have_levels = true;
+        levels = e->value;
+    }
+    return changes;
+}
+
+int64_t trace_min_interval_ns(const Trace_Buffer& trace, uint32_t mask){
+    Trace_Walk walk(trace);
+    const Trace_Event* e;
+    bool have_levels = false, have_change = false;
+    uint32_t levels = 0;
+    uint64_t last_change = 0, min_ticks = UINT64_MAX;
+
+    while((e = walk.step()) != NULL){
+        if(e->kind != TRACE_GPIO)
+            continue;
+        if(have_levels && ((e->value ^ levels) & mask)){
+            if(have_change && walk.time() - last_change < min_ticks)
+                min_ticks = walk.time() - last_change;
+            have_change = true;
+            last_change = walk.time();
+        }
+        have_levels = true;
+        levels = e->value;
+    }
+    if(min_ticks == UINT64_MAX)
+        return -1;
+    return (int64_t)trace.ticks_to_ns(min_ticks);
+}
+
+int trace_pulses(const Trace_Buffer& trace, uint8_t gpio, bool level, Trace_Pulses* out){
+    *out = Trace_Pulses();
+    if(gpio >= 32 || !(trace.get_pin_mask() & (1u << gpio)))
+        return -1;
+    uint32_t bit = 1u << gpio;
+
+    Trace_Walk walk(trace);
+    const Trace_Event* e;
+    bool have_levels = false, in_pulse = false;
+    bool current = false;
+    uint64_t start = 0;
+
+    while((e = walk.step()) != NULL){
+        if(e->kind != TRACE_GPIO)
+            continue;
+        bool value = (e->value & bit) != 0;
+        if(have_levels && value != current){
+            if(value == level){
+                in_pulse = true;
+                start = walk.time();
+            }else if(in_pulse){
+                uint64_t width = trace.ticks_to_ns(walk.time() - start);
+                if(out->count == 0 || width < out->min_ns)
+                    out->min_ns = width;
+                if(width > out->max_ns)
+                    out->max_ns = width;
+                out->total_ns += width;
+                out->count++;
+                in_pulse = false;
+            }
+        }
+        have_levels = true;
+        current = value;
+    }
+    return (int)out->count;
+}
+
+void trace_i2c_summary(const Trace_Buffer& trace, uint8_t addr, Trace_I2C_Summary* out){
+    *out = Trace_I2C_Summary();
+    out->min_gap_ns = -1;
+
+    Trace_Walk walk(trace);
+    const Trace_Event* e;
+    uint64_t busy_ticks = 0, last_end = 0;
+
+    while((e = walk.step()) != NULL){
+        if(e->kind == TRACE_GPIO || e->addr != addr)
+            continue;
+        if(out->transfers > 0 && walk.time() >= last_end){
+            int64_t gap = (int64_t)trace.ticks_to_ns(walk.time() - last_end);
+            if(out->min_gap_ns < 0 || gap < out->min_gap_ns)
+                out->min_gap_ns = gap;
+        }
+        out->transfers++;
+        if(e->result < 0)
+            out->failed++;
+        busy_ticks += e->value;
+        last_end = walk.time() + e->value;
+    }
+    out->busy_ns = trace.ticks_to_ns(busy_ticks);
+}
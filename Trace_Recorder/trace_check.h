@@ -0,0 +1,35 @@
+/*
+ * Timing measurements on a trace, for tests that assert driver timing directly:
+ *      CHECK(trace_min_interval_ns(trace, STEPPER_PINS) >= 2000000);     // no step closer than 2ms
+ *      trace_pulses(trace, CC2, false, &on);                             // right digit lit (cathode low)
+ *      CHECK(on.min_ns >= 4000000);
+ */
+#ifndef TRACE_CHECK_H
+#define TRACE_CHECK_H
+
+#include "trace.h"
+
+/*
+ * Complete pulses at one level: both edges are inside the trace, the level before the first
+ *  recorded change doesn't count since its start is unknown
+ */
+struct Trace_Pulses {
+    uint32_t count;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t total_ns;
+};
+
+struct Trace_I2C_Summary {
+    uint32_t transfers;     // reads and writes to the address
+    uint32_t failed;        // NACKed or timed out
+    uint64_t busy_ns;       // bus time used by them
+    int64_t min_gap_ns;     // shortest time from the end of one transfer to the start of the next, -1 if < 2
+};
+
+int trace_count_changes(const Trace_Buffer& trace, uint32_t mask);        // events where a pin in mask changed
+int64_t trace_min_interval_ns(const Trace_Buffer& trace, uint32_t mask);  // shortest time between two changes of pins in mask, -1 if < 2
+int trace_pulses(const Trace_Buffer& trace, uint8_t gpio, bool level, Trace_Pulses* out); // returns the count, -1 if gpio isn't traced
+void trace_i2c_summary(const Trace_Buffer& trace, uint8_t addr, Trace_I2C_Summary* out);
+
+#endif
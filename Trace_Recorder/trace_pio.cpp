@@ -0,0 +1,114 @@
+/*
+ * Board feed for the trace recorder, PIO sampling into a DMA ring
+ */
+#include "trace_pio.h"
+#include "trace_sample.pio.h"
+#include <hardware/dma.h>
+#include <hardware/clocks.h>
+
+#define TRACE_PIO_TRANSFERS 0xFFFFFFFFu /*DMA transfer count, re-armed by poll() when it runs out*/
+#define TRACE_PIO_MAX_CLKDIV 65536      /*largest state machine clock divider, 16 bit integer part where 0 means 65536*/
+
+Trace_PIO::Trace_PIO(PIO pio){
+    this->pio = pio;
+    trace = NULL;
+    sm = 0;
+    offset = 0;
+    dma_chan = -1;
+    arm_base = 0;
+    samples_read = 0;
+    samples_lost = 0;
+}
+
+int Trace_PIO::start(Trace_Buffer* trace){
+    uint32_t sys_hz = clock_get_hz(clk_sys);
+    uint32_t tick_hz = trace->get_tick_hz();
+    if(this->trace != NULL || tick_hz == 0 || tick_hz > sys_hz)
+        return -1;
+    if(sys_hz / tick_hz > TRACE_PIO_MAX_CLKDIV || (sys_hz / tick_hz == TRACE_PIO_MAX_CLKDIV && sys_hz % tick_hz != 0))
+        return -1; // slower than the state machine divider can go
+    if(!pio_can_add_program(pio, &trace_sample_program))
+        return -1;
+    int claimed_sm = pio_claim_unused_sm(pio, false);
+    if(claimed_sm < 0)
+        return -1;
+    dma_chan = dma_claim_unused_channel(false);
+    if(dma_chan < 0){
+        pio_sm_unclaim(pio, claimed_sm);
+        return -1;
+    }
+    sm = (uint)claimed_sm;
+    offset = pio_add_program(pio, &trace_sample_program);
+
+    // 32 pins from GPIO 0 per sample, one sample per FIFO word, both FIFOs joined for RX
+    pio_sm_config c = trace_sample_program_get_default_config(offset);
+    sm_config_set_in_pins(&c, 0);
+    sm_config_set_in_shift(&c, false, true, 32);
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_RX);
+    sm_config_set_clkdiv(&c, (float)sys_hz / tick_hz);
+    pio_sm_init(pio, sm, offset, &c);
+
+    dma_channel_config d = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&d, DMA_SIZE_32);
+    channel_config_set_read_increment(&d, false);
+    channel_config_set_write_increment(&d, true);
+    channel_config_set_ring(&d, true, TRACE_PIO_RING_BITS);    // wrap the write address inside ring[]
+    channel_config_set_dreq(&d, pio_get_dreq(pio, sm, false));
+    dma_channel_configure(dma_chan, &d, ring, &pio->rxf[sm], TRACE_PIO_TRANSFERS, true);
+
+    this->trace = trace;
+    arm_base = 0;
+    samples_read = 0;
+    samples_lost = 0;
+    pio_sm_set_enabled(pio, sm, true);
+    return 0;
+}
+
+/*
+ * Count from the DMA's remaining transfers, modulo 2^32 like the trace times
+ */
+uint32_t Trace_PIO::samples_written(void) const {
+    return arm_base + (TRACE_PIO_TRANSFERS - dma_hw->ch[dma_chan].transfer_count);
+}
+
+void Trace_PIO::poll(void){
+    if(trace == NULL)
+        return;
+    bool finished = !dma_channel_is_busy(dma_chan);
+    uint32_t written = samples_written();
+    uint32_t pending = written - samples_read;
+
+    if(pending > TRACE_PIO_RING_WORDS){
+        // the DMA lapped the reader, what it overwrote is gone
+        samples_lost += pending - TRACE_PIO_RING_WORDS;
+        samples_read = written - TRACE_PIO_RING_WORDS;
+        pending = TRACE_PIO_RING_WORDS;
+    }
+    for(; pending > 0; pending--){
+        trace->record_gpio(samples_read, ring[samples_read % TRACE_PIO_RING_WORDS]);
+        samples_read++;
+    }
+
+    if(finished){
+        // 2^32 samples done, keep going from the current write address
+        arm_base = written;
+        dma_channel_set_trans_count(dma_chan, TRACE_PIO_TRANSFERS, true);
+    }
+}
+
+void Trace_PIO::stop(void){
+    if(trace == NULL)
+        return;
+    pio_sm_set_enabled(pio, sm, false);
+    poll();
+    dma_channel_abort(dma_chan);
+    dma_channel_unclaim(dma_chan);
+    pio_remove_program(pio, &trace_sample_program, offset);
+    pio_sm_unclaim(pio, sm);
+    trace = NULL;
+    dma_chan = -1;
+}
+
+uint32_t Trace_PIO::get_samples_lost(void) const {
+    return samples_lost;
+}
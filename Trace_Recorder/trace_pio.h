@@ -0,0 +1,47 @@
+/*
+ * Board feed: a PIO state machine samples GPIO 0-31 at the trace's tick rate and DMA writes the
+ *  samples into a ring in RAM without using the CPU. poll() turns the new samples into change
+ *  events in the trace, so only the changes of the traced pins are kept. I2C shows up as the SDA
+ *  and SCL levels when those pins are traced, GTKWave's I2C decoder reads them from the VCD.
+ *
+ *  Sampling costs no CPU time, but poll() has to run at least once per TRACE_PIO_RING_WORDS
+ *  samples (1ms at 1MHz) or the DMA overwrites samples before they are read. Those are counted
+ *  in get_samples_lost().
+ *
+ *  The ring is aligned to its size for the DMA ring mode, make the object static or global.
+ */
+#ifndef TRACE_PIO_H
+#define TRACE_PIO_H
+
+#include "trace.h"
+#include <hardware/pio.h>
+
+#ifndef TRACE_PIO_RING_BITS
+#define TRACE_PIO_RING_BITS 12  /*4KB DMA ring, the DMA ring size is a power of two up to 32KB*/
+#endif
+#define TRACE_PIO_RING_WORDS ((1u << TRACE_PIO_RING_BITS) / 4)
+
+class Trace_PIO {
+    private:
+        alignas(1 << TRACE_PIO_RING_BITS) uint32_t ring[TRACE_PIO_RING_WORDS];  // DMA writes samples here
+        Trace_Buffer* trace;    // NULL when stopped
+        PIO pio;
+        uint sm;
+        uint offset;            // program location in PIO instruction memory
+        int dma_chan;
+        uint32_t arm_base;      // samples written before the DMA transfer count was last armed
+        uint32_t samples_read;  // samples turned into events, also the tick of the next sample
+        uint32_t samples_lost;
+
+        uint32_t samples_written(void) const;
+
+    public:
+        Trace_PIO(PIO pio=pio0);
+
+        int start(Trace_Buffer* trace);     // sample at trace->get_tick_hz(), <0 if no free state machine/DMA channel, or the rate is above clk_sys or below clk_sys / 65536
+        void poll(void);                    // move new samples into the trace
+        void stop(void);                    // poll once more and release the state machine and DMA channel
+        uint32_t get_samples_lost(void) const;
+};
+
+#endif
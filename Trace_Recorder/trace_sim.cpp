@@ -0,0 +1,36 @@
+/*
+ * Host feed for the trace recorder
+ */
+#include "trace_sim.h"
+
+/*
+ * Cycles to trace ticks, split so cycles * tick_hz can't overflow
+ */
+static uint32_t to_ticks(const Trace_Buffer* trace, uint64_t cycles){
+    uint64_t hz = trace->get_tick_hz();
+    if(hz == SIM_CLK_SYS_HZ)
+        return (uint32_t)cycles;
+    return (uint32_t)(cycles / SIM_CLK_SYS_HZ * hz + cycles % SIM_CLK_SYS_HZ * hz / SIM_CLK_SYS_HZ);
+}
+
+static void on_gpio(uint64_t cycle, uint32_t outputs, void* ctx){
+    Trace_Buffer* trace = (Trace_Buffer*)ctx;
+    trace->record_gpio(to_ticks(trace, cycle), outputs);
+}
+
+static void on_i2c(uint64_t cycle, uint64_t duration_cycles, uint8_t addr, bool read, const uint8_t* data, int result, void* ctx){
+    Trace_Buffer* trace = (Trace_Buffer*)ctx;
+    uint32_t start = to_ticks(trace, cycle);
+    trace->record_i2c(start, to_ticks(trace, cycle + duration_cycles) - start, addr, read, data, result);
+}
+
+void trace_sim_attach(Trace_Buffer* trace){
+    trace->record_gpio(to_ticks(trace, sim_cycles()), sim_gpio_outputs());
+    sim_set_gpio_observer(on_gpio, trace);
+    sim_set_i2c_observer(on_i2c, trace);
+}
+
+void trace_sim_detach(void){
+    sim_set_gpio_observer(NULL, NULL);
+    sim_set_i2c_observer(NULL, NULL);
+}
@@ -0,0 +1,17 @@
+/*
+ * Host feed: records the simulated board into a trace through the simulator's observers. Every SIO
+ *  write and I2C transfer made by the drivers is seen at the cycle it happens, so the trace is exact
+ *  and the same on every run.
+ */
+#ifndef TRACE_SIM_H
+#define TRACE_SIM_H
+
+#include "trace.h"
+#include "sim.h"
+
+#define TRACE_SIM_TICK_HZ SIM_CLK_SYS_HZ    /*tick rate to create the Trace_Buffer with, one tick per cycle*/
+
+void trace_sim_attach(Trace_Buffer* trace); // start recording, the current pin levels are the first event. sim_reset() detaches.
+void trace_sim_detach(void);
+
+#endif
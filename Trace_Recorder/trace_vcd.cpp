@@ -0,0 +1,136 @@
+/*
+ * VCD export of a trace
+ */
+#include "trace_vcd.h"
+
+#define VCD_ID_FIRST '!'    /*identifiers are single printable characters, one per pin then the I2C signals*/
+
+enum VCD_I2C_Signal {VCD_I2C_BUSY=32, VCD_I2C_READ, VCD_I2C_NACK, VCD_I2C_ADDR, VCD_I2C_DATA};
+
+static char vcd_id(int signal){
+    return (char)(VCD_ID_FIRST + signal);
+}
+
+static void write_vector(FILE* out, uint32_t value, int bits, int signal){
+    fputc('b', out);
+    for(int b = bits - 1; b >= 0; b--)
+        fputc((value >> b) & 1 ? '1' : '0', out);
+    fprintf(out, " %c\n", vcd_id(signal));
+}
+
+/*
+ * Emits a timestamp only when time moved, events at the same instant share one
+ */
+class VCD_Clock {
+    private:
+        FILE* out;
+        const Trace_Buffer& trace;
+        bool started;
+        uint64_t last_ns;
+
+    public:
+        VCD_Clock(FILE* out, const Trace_Buffer& trace) : out(out), trace(trace){
+            started = false;
+            last_ns = 0;
+        }
+
+        void at(uint64_t ticks){
+            uint64_t ns = trace.ticks_to_ns(ticks);
+            if(started && ns == last_ns)
+                return;
+            fprintf(out, "#%llu\n", (unsigned long long)ns);
+            started = true;
+            last_ns = ns;
+        }
+};
+
+int trace_write_vcd(const Trace_Buffer& trace, FILE* out, const Trace_Signal* names, int name_count){
+    uint32_t mask = trace.get_pin_mask();
+    bool has_i2c = false;
+    for(uint32_t i = 0; i < trace.size(); i++){
+        if(trace.at(i).kind != TRACE_GPIO)
+            has_i2c = true;
+    }
+
+    fprintf(out, "$version RP2040_Libraries trace $end\n");
+    fprintf(out, "$timescale 1ns $end\n");
+    fprintf(out, "$scope module rp2040 $end\n");
+    for(int pin = 0; pin < 32; pin++){
+        if(!(mask & (1u << pin)))
+            continue;
+        const char* name = NULL;
+        for(int n = 0; n < name_count; n++){
+            if(names[n].gpio == pin)
+                name = names[n].name;
+        }
+        if(name != NULL)
+            fprintf(out, "$var wire 1 %c %s $end\n", vcd_id(pin), name);
+        else
+            fprintf(out, "$var wire 1 %c gpio%d $end\n", vcd_id(pin), pin);
+    }
+    if(has_i2c){
+        fprintf(out, "$var wire 1 %c i2c_busy $end\n", vcd_id(VCD_I2C_BUSY));
+        fprintf(out, "$var wire 1 %c i2c_read $end\n", vcd_id(VCD_I2C_READ));
+        fprintf(out, "$var wire 1 %c i2c_nack $end\n", vcd_id(VCD_I2C_NACK));
+        fprintf(out, "$var wire 7 %c i2c_addr $end\n", vcd_id(VCD_I2C_ADDR));
+        fprintf(out, "$var wire 8 %c i2c_data $end\n", vcd_id(VCD_I2C_DATA));
+    }
+    fprintf(out, "$upscope $end\n$enddefinitions $end\n");
+
+    // pins are unknown until the first GPIO event
+    VCD_Clock clock(out, trace);
+    clock.at(0);
+    fprintf(out, "$dumpvars\n");
+    for(int pin = 0; pin < 32; pin++){
+        if(mask & (1u << pin))
+            fprintf(out, "x%c\n", vcd_id(pin));
+    }
+    if(has_i2c){
+        fprintf(out, "0%c\n0%c\n0%c\n", vcd_id(VCD_I2C_BUSY), vcd_id(VCD_I2C_READ), vcd_id(VCD_I2C_NACK));
+        write_vector(out, 0, 7, VCD_I2C_ADDR);
+        write_vector(out, 0, 8, VCD_I2C_DATA);
+    }
+    fprintf(out, "$end\n");
+
+    bool have_levels = false, busy = false;
+    uint32_t levels = 0;
+    uint32_t last_time = trace.size() > 0 ? trace.at(0).time : 0;
+    uint64_t now = 0, busy_until = 0;
+
+    for(uint32_t i = 0; i < trace.size(); i++){
+        const Trace_Event& e = trace.at(i);
+        now += (uint32_t)(e.time - last_time);
+        last_time = e.time;
+
+        if(busy && busy_until <= now){
+            clock.at(busy_until);
+            fprintf(out, "0%c\n", vcd_id(VCD_I2C_BUSY));
+            busy = false;
+        }
+
+        clock.at(now);
+        if(e.kind == TRACE_GPIO){
+            uint32_t changed = have_levels ? (e.value ^ levels) & mask : mask;
+            for(int pin = 0; pin < 32; pin++){
+                if(changed & (1u << pin))
+                    fprintf(out, "%c%c\n", (e.value >> pin) & 1 ? '1' : '0', vcd_id(pin));
+            }
+            have_levels = true;
+            levels = e.value;
+        }else{
+            fprintf(out, "1%c\n", vcd_id(VCD_I2C_BUSY));
+            fprintf(out, "%c%c\n", e.kind == TRACE_I2C_READ ? '1' : '0', vcd_id(VCD_I2C_READ));
+            fprintf(out, "%c%c\n", e.result < 0 ? '1' : '0', vcd_id(VCD_I2C_NACK));
+            write_vector(out, e.addr, 7, VCD_I2C_ADDR);
+            write_vector(out, e.data, 8, VCD_I2C_DATA);
+            if(!busy || now + e.value > busy_until)
+                busy_until = now + e.value;
+            busy = true;
+        }
+    }
+    if(busy){
+        clock.at(busy_until);
+        fprintf(out, "0%c\n", vcd_id(VCD_I2C_BUSY));
+    }
+    return ferror(out) ? -1 : 0;
+}
@@ -0,0 +1,23 @@
+/*
+ * Export a trace as a Value Change Dump (IEEE 1364 VCD) for GTKWave or any other waveform viewer.
+ *  Every traced pin is a 1 bit wire. If the trace has I2C transfers they are shown as
+ *  i2c_busy, i2c_read, i2c_nack, i2c_addr and i2c_data signals, valid while i2c_busy is high.
+ *  Time 0 is the oldest event in the ring, the timescale is 1ns.
+ */
+#ifndef TRACE_VCD_H
+#define TRACE_VCD_H
+
+#include "trace.h"
+#include <stdio.h>
+
+/*
+ * Name for a pin in the dump, pins without one are called gpio<n>
+ */
+struct Trace_Signal {
+    uint8_t gpio;
+    const char* name;   // no spaces
+};
+
+int trace_write_vcd(const Trace_Buffer& trace, FILE* out, const Trace_Signal* names=NULL, int name_count=0); // 0, -1 on write error
+
+#endif
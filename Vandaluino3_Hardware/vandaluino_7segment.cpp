@@ -0,0 +1,48 @@
+/*
+ * Vandaluino3 two digit 7 segment display
+ */
+#include "vandaluino_7segment.h"
+#include "driver_instrument.h"
+
+/*
+ *  Initialize the GPIO pins for the 7 segment display to be outputs and set LOW
+ */
+void init_7_segment(void){
+    // init the common cathodes as outputs, HIGH initially so nothing shows
+    gpio_init_mask(CCX);
+    gpio_set_dir_out_masked(CCX);
+    gpio_set_mask(CCX); // raise both so that neither is displaying
+
+    // init letter segments and set them as outputs
+    // don't have to drive low because that is done by default on init
+    gpio_init_mask(ALL_SEGMENTS);
+    gpio_set_dir_out_masked(ALL_SEGMENTS);
+
+    // init built-in LED
+    gpio_init(LED_BUILTIN);
+    gpio_set_dir(LED_BUILTIN, GPIO_OUT);
+}
+
+/*
+ * Light right digit, can be used for testing or simple projects
+ */
+void show_on_right(uint32_t bitmask){
+    INSTR_SCOPE(INSTR_DISPLAY_REFRESH);
+    gpio_set_mask(CCX);
+    gpio_clr_mask(ALL_SEGMENTS);
+
+    gpio_set_mask(bitmask);
+    gpio_clr_mask(RIGHT_ON);
+}
+
+/*
+ * Light left digit
+ */
+void show_on_left(uint32_t bitmask){
+    INSTR_SCOPE(INSTR_DISPLAY_REFRESH);
+    gpio_set_mask(CCX);
+    gpio_clr_mask(ALL_SEGMENTS);
+
+    gpio_set_mask(bitmask);
+    gpio_clr_mask(LEFT_ON);
+}
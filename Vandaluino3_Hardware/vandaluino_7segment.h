@@ -17,7 +17,8 @@
 #define NULL_VAL 0b0010000000000000000000000000000
 #define BLANK_VAL 0b0000000000000000000000000000000
 
-const int SEGMENT_NUM[] = {
+// segment patterns, inline constexpr so every file including this shares one copy in flash
+inline constexpr uint32_t SEGMENT_NUM[] = {
   //0b0CGBAEP00000D0000000000F0000000
     0b0101110000001000000000010000000, // 0
     0b0101000000000000000000000000000, // 1
@@ -31,7 +32,7 @@ const int SEGMENT_NUM[] = {
     0b0111100000001000000000010000000, // 9
 };
 
-const int SEGMENT_HEX[] = {
+inline constexpr uint32_t SEGMENT_HEX[] = {
   //0b0CGBAEP00000D0000000000F0000000
     0b0101110000001000000000010000000, // 0
     0b0101000000000000000000000000000, // 1
@@ -51,44 +52,8 @@ const int SEGMENT_HEX[] = {
     0b0010110000000000000000010000000, // F
 };
 
-/*
- *  Initialize the GPIO pins for the 7 segment display to be outputs and set LOW
- */
-void init_7_segment(){
-    // init the common cathodes as outputs, HIGH initially so nothing shows
-    gpio_init_mask(CCX);
-    gpio_set_dir_out_masked(CCX);
-    gpio_set_mask(CCX); // raise both so that neither is displaying
+void init_7_segment(void);           // both digits and the built-in LED as outputs, nothing lit
+void show_on_right(uint32_t bitmask);  // light the right digit with a SEGMENT_NUM/SEGMENT_HEX pattern
+void show_on_left(uint32_t bitmask);   // light the left digit
 
-    // init letter segments and set them as outputs
-    // don't have to drive low because that is done by default on init
-    gpio_init_mask(ALL_SEGMENTS);
-    gpio_set_dir_out_masked(ALL_SEGMENTS);
-
-    // init built-in LED
-    gpio_init(LED_BUILTIN);
-    gpio_set_dir(LED_BUILTIN, GPIO_OUT);
-}
-
-/*
- * Light right digit, can be used for testing or simple projects
- */
-void show_on_right(uint32_t bitmask){
-    gpio_set_mask(CCX);
-    gpio_clr_mask(ALL_SEGMENTS);
-
-    gpio_set_mask(bitmask);
-    gpio_clr_mask(RIGHT_ON);
-}
-
-/*
- * Light left digit
- */
-void show_on_left(uint32_t bitmask){
-    gpio_set_mask(CCX);
-    gpio_clr_mask(ALL_SEGMENTS);
-
-    gpio_set_mask(bitmask);
-    gpio_clr_mask(LEFT_ON);
-}
 #endif
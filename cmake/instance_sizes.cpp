@@ -0,0 +1,31 @@
+/*
+ * Per-instance RAM of the driver classes, for size_report. Each array is as large as one object
+ *  of the class, the report reads the sizes from the symbol table (nm) so it works for the board
+ *  build as well as the host build. Nothing links this.
+ */
+#include "driver_diag.h"
+#include "alarm_sleep.h"
+#include "hdc1080.h"
+#include "hdc1080_low_power.h"
+#include "SM_28BYJ-48.h"
+#include "flash_log.h"
+#include "telemetry.h"
+#include "dual_core.h"
+#include "async_drivers.h"
+#include "trace.h"
+
+#define INSTANCE_SIZE(type) extern "C" { char instance_size_##type[sizeof(type)]; }
+
+INSTANCE_SIZE(Driver_Diag)
+INSTANCE_SIZE(Alarm_Sleep)
+INSTANCE_SIZE(HDC1080)
+INSTANCE_SIZE(HDC1080_Low_Power)
+INSTANCE_SIZE(SM_28BYJ_48)
+INSTANCE_SIZE(Flash_Log)
+INSTANCE_SIZE(Telemetry)
+INSTANCE_SIZE(Core_Load)
+INSTANCE_SIZE(RT_Core)
+INSTANCE_SIZE(Executor)
+INSTANCE_SIZE(Async_HDC1080)
+INSTANCE_SIZE(Async_Stepper)
+INSTANCE_SIZE(Trace_Buffer)
@@ -0,0 +1,93 @@
+# Per-module footprint: runs the size tool over each module library and prints one line per module
+# with the text/data/bss the module adds to a firmware that uses all of it.
+# Then the RAM one object of each driver class takes, from the instance_size_<class> arrays.
+#   cmake -DSIZE_TOOL=<size> -DMODULES="name=lib.a|..." [-DNM_TOOL=<nm> -DINSTANCES="obj|..."]
+#         -DOUTPUT=<file> -P size_report.cmake
+# text includes .rodata (tables in flash), data costs flash and RAM, bss costs RAM.
+
+set(report "module                     text     data      bss\n")
+set(total_text 0)
+set(total_data 0)
+set(total_bss 0)
+
+string(REPLACE "|" ";" modules "${MODULES}")
+foreach(entry ${modules})
+    if(entry STREQUAL "")
+        continue()
+    endif()
+    string(REPLACE "=" ";" pair "${entry}")
+    list(GET pair 0 name)
+    list(GET pair 1 lib)
+
+    execute_process(COMMAND ${SIZE_TOOL} -t ${lib}
+        OUTPUT_VARIABLE out
+        RESULT_VARIABLE result
+        ERROR_QUIET)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "${SIZE_TOOL} failed on ${lib}")
+    endif()
+
+    # last line: text data bss dec hex (TOTALS)
+    string(REGEX MATCH "([0-9]+)[ \t]+([0-9]+)[ \t]+([0-9]+)[ \t]+[0-9]+[ \t]+[0-9a-f]+[ \t]+\\(TOTALS\\)" totals "${out}")
+    set(text ${CMAKE_MATCH_1})
+    set(data ${CMAKE_MATCH_2})
+    set(bss ${CMAKE_MATCH_3})
+
+    math(EXPR total_text "${total_text} + ${text}")
+    math(EXPR total_data "${total_data} + ${data}")
+    math(EXPR total_bss "${total_bss} + ${bss}")
+    string(LENGTH "${name}" len)
+    math(EXPR pad "22 - ${len}")
+    string(REPEAT " " ${pad} spaces)
+    string(APPEND report "${name}${spaces}")
+    foreach(value ${text} ${data} ${bss})
+        string(LENGTH "${value}" len)
+        math(EXPR pad "9 - ${len}")
+        string(REPEAT " " ${pad} spaces)
+        string(APPEND report "${spaces}${value}")
+    endforeach()
+    string(APPEND report "\n")
+endforeach()
+
+string(APPEND report "total                 ")
+foreach(value ${total_text} ${total_data} ${total_bss})
+    string(LENGTH "${value}" len)
+    math(EXPR pad "9 - ${len}")
+    string(REPEAT " " ${pad} spaces)
+    string(APPEND report "${spaces}${value}")
+endforeach()
+string(APPEND report "\n")
+
+if(NM_TOOL AND INSTANCES)
+    string(APPEND report "\nper instance               bytes\n")
+    string(REPLACE "|" ";" objects "${INSTANCES}")
+    foreach(obj ${objects})
+        execute_process(COMMAND ${NM_TOOL} -S ${obj}
+            OUTPUT_VARIABLE out
+            RESULT_VARIABLE result
+            ERROR_QUIET)
+        if(NOT result EQUAL 0)
+            message(FATAL_ERROR "${NM_TOOL} failed on ${obj}")
+        endif()
+
+        # address size type name, sizes are hex
+        string(REGEX MATCHALL "[0-9a-fA-F]+ [0-9a-fA-F]+ [BbCcDd] _?instance_size_[A-Za-z0-9_]+" symbols "${out}")
+        foreach(symbol ${symbols})
+            string(REGEX MATCH "[0-9a-fA-F]+ ([0-9a-fA-F]+) [BbCcDd] _?instance_size_([A-Za-z0-9_]+)" parts "${symbol}")
+            math(EXPR bytes "0x${CMAKE_MATCH_1}")
+            set(name ${CMAKE_MATCH_2})
+            string(LENGTH "${name}" len)
+            math(EXPR pad "22 - ${len}")
+            string(REPEAT " " ${pad} spaces)
+            string(LENGTH "${bytes}" len)
+            math(EXPR pad "9 - ${len}")
+            string(REPEAT " " ${pad} value_spaces)
+            string(APPEND report "${name}${spaces}${value_spaces}${bytes}\n")
+        endforeach()
+    endforeach()
+endif()
+
+message("${report}")
+if(OUTPUT)
+    file(WRITE ${OUTPUT} "${report}")
+endif()
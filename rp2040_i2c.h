@@ -9,9 +9,10 @@
 #include <pico/stdlib.h>
 
 /*
- * All the functions needed to intialize and configure the I2C interface on the pico
+ * All the functions needed to intialize and configure the I2C interface on the pico.
+ *  inline so the header can be included from more than one source file.
  */
-void init_i2c(i2c_inst_t* i2c_port){
+inline void init_i2c(i2c_inst_t* i2c_port){
     i2c_init(i2c_port, 100*1000); // set port and set baud rate to 100kHz
     gpio_set_function(PICO_DEFAULT_I2C_SDA_PIN, GPIO_FUNC_I2C);
     gpio_set_function(PICO_DEFAULT_I2C_SCL_PIN, GPIO_FUNC_I2C);